@@ -0,0 +1,224 @@
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <atomic>
+#include <algorithm>
+#include <fstream>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include "numerical_differentiation.hpp"
+
+/**
+ * Бенчмарк этапов численного дифференцирования.
+ * Запуск: NumericalDifferentiationBenchmark [max_exponent=9] [memory_limit_gib=4] [threads=0]
+ * Перебирает M = 10^2 ... 10^max_exponent для float, double, long double и печатает в stdout CSV:
+ *   type,M,stage,repeats,seconds,ns_per_node,gb_per_s,allocations,bytes_allocated
+ * seconds и ns_per_node - среднее по повторам, allocations и bytes_allocated - за один вызов этапа.
+ * Размеры, для которых оценка памяти превышает memory_limit_gib, пропускаются (строка с stage=skipped).
+ */
+
+namespace Alloc_counter { // Подсчет выделений памяти через глобальный operator new
+    inline std::atomic<std::size_t> count{0};
+    inline std::atomic<std::size_t> bytes{0};
+
+    // Все формы operator new/delete заменены и идут через эти две функции. Для выровненных форм
+    // исходный указатель malloc хранится перед выровненным блоком. noinline: иначе GCC после встраивания
+    // видит free() для памяти из operator new и выдает ложное -Wmismatched-new-delete.
+    [[gnu::noinline]] inline void* allocate(std::size_t size, std::size_t alignment) noexcept {
+        count++;
+        bytes += size;
+        if (alignment <= alignof(std::max_align_t)) return std::malloc(size == 0 ? 1 : size);
+        void* raw = std::malloc(size + alignment + sizeof(void*));
+        if (raw == nullptr) return nullptr;
+        std::uintptr_t aligned = (reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*) + alignment - 1) & ~(alignment - 1);
+        reinterpret_cast<void**>(aligned)[-1] = raw;
+        return reinterpret_cast<void*>(aligned);
+    }
+    [[gnu::noinline]] inline void release(void* ptr, std::size_t alignment) noexcept {
+        if (ptr == nullptr) return;
+        if (alignment <= alignof(std::max_align_t)) std::free(ptr);
+        else std::free(reinterpret_cast<void**>(ptr)[-1]);
+    }
+    inline void* allocate_or_throw(std::size_t size, std::size_t alignment) {
+        if (void* ptr = allocate(size, alignment)) return ptr;
+        throw std::bad_alloc();
+    }
+}
+using Alloc_counter::allocate;
+using Alloc_counter::allocate_or_throw;
+using Alloc_counter::release;
+constexpr std::size_t DEFAULT_ALIGN = alignof(std::max_align_t);
+
+void* operator new(std::size_t size){ return allocate_or_throw(size, DEFAULT_ALIGN); }
+void* operator new[](std::size_t size){ return allocate_or_throw(size, DEFAULT_ALIGN); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size, DEFAULT_ALIGN); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size, DEFAULT_ALIGN); }
+void* operator new(std::size_t size, std::align_val_t al){ return allocate_or_throw(size, static_cast<std::size_t>(al)); }
+void* operator new[](std::size_t size, std::align_val_t al){ return allocate_or_throw(size, static_cast<std::size_t>(al)); }
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return allocate(size, static_cast<std::size_t>(al)); }
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return allocate(size, static_cast<std::size_t>(al)); }
+
+void operator delete(void* ptr) noexcept { release(ptr, DEFAULT_ALIGN); }
+void operator delete[](void* ptr) noexcept { release(ptr, DEFAULT_ALIGN); }
+void operator delete(void* ptr, std::size_t) noexcept { release(ptr, DEFAULT_ALIGN); }
+void operator delete[](void* ptr, std::size_t) noexcept { release(ptr, DEFAULT_ALIGN); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { release(ptr, DEFAULT_ALIGN); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { release(ptr, DEFAULT_ALIGN); }
+void operator delete(void* ptr, std::align_val_t al) noexcept { release(ptr, static_cast<std::size_t>(al)); }
+void operator delete[](void* ptr, std::align_val_t al) noexcept { release(ptr, static_cast<std::size_t>(al)); }
+void operator delete(void* ptr, std::size_t, std::align_val_t al) noexcept { release(ptr, static_cast<std::size_t>(al)); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t al) noexcept { release(ptr, static_cast<std::size_t>(al)); }
+void operator delete(void* ptr, std::align_val_t al, const std::nothrow_t&) noexcept { release(ptr, static_cast<std::size_t>(al)); }
+void operator delete[](void* ptr, std::align_val_t al, const std::nothrow_t&) noexcept { release(ptr, static_cast<std::size_t>(al)); }
+
+namespace Bench_const {
+    inline constexpr std::size_t MIN_EXPONENT = 2;
+    inline constexpr std::size_t TARGET_NODES = 20'000'000; ///Суммарное количество узлов за все повторы этапа (для малых M)
+    inline constexpr std::size_t MAX_REPEATS = 1000;
+    inline constexpr std::size_t MAX_JSON_NODES = 100'000; ///Текстовый формат медленный, больше не измеряем
+    inline constexpr std::size_t ARRAYS_PER_NODE = 14; ///Оценка количества массивов размера M, живущих одновременно
+}
+
+/**
+ * @brief Функция измерения одного этапа и вывода строки CSV
+ * @param type_name Имя типа данных
+ * @param count_nodes Количество узлов M
+ * @param stage Имя этапа
+ * @param bytes_moved Объем памяти, который этап читает и записывает за один вызов
+ * @param run Вызов этапа, возвращает функцию освобождения результата
+ */
+template <typename Run>
+void measure_stage(const std::string& type_name, const std::size_t count_nodes, const std::string& stage, const double bytes_moved, Run&& run){
+    const std::size_t repeats = std::clamp<std::size_t>(Bench_const::TARGET_NODES / count_nodes, 1, Bench_const::MAX_REPEATS);
+    std::size_t allocations = 0, bytes_allocated = 0;
+    double seconds = 0.0;
+    for (std::size_t r = 0; r < repeats; r++){
+        std::size_t count_before = Alloc_counter::count, bytes_before = Alloc_counter::bytes;
+        auto start = std::chrono::steady_clock::now();
+        auto release = run();
+        auto stop = std::chrono::steady_clock::now();
+        if (r == 0){
+            allocations = Alloc_counter::count - count_before;
+            bytes_allocated = Alloc_counter::bytes - bytes_before;
+        }
+        seconds += std::chrono::duration<double>(stop - start).count();
+        release();
+    }
+    seconds /= repeats;
+    std::cout << type_name << ',' << count_nodes << ',' << stage << ',' << repeats << ','
+              << std::scientific << std::setprecision(6) << seconds << ','
+              << seconds * 1e9 / count_nodes << ','
+              << bytes_moved / seconds / 1e9 << ','
+              << std::defaultfloat << allocations << ',' << bytes_allocated << '\n' << std::flush;
+}
+
+template <typename T>
+void run_benchmark(const std::string& type_name, const std::size_t max_exponent, const double memory_limit_bytes){
+    std::size_t count_nodes = 1;
+    for (std::size_t e = 0; e < Bench_const::MIN_EXPONENT; e++) count_nodes *= 10;
+    for (std::size_t exponent = Bench_const::MIN_EXPONENT; exponent <= max_exponent; exponent++, count_nodes *= 10){
+        if (static_cast<double>(Bench_const::ARRAYS_PER_NODE) * count_nodes * sizeof(T) > memory_limit_bytes){
+            std::cout << type_name << ',' << count_nodes << ",skipped,0,0,0,0,0,0\n";
+            continue;
+        }
+        const double bytes_node = sizeof(T);
+        const T a = Task_const::A, b = Task_const::B;
+        std::size_t count_h = 0, count_h_2 = 0;
+        auto none = std::make_tuple<T*, T*, T*>(nullptr, nullptr, nullptr);
+
+        measure_stage(type_name, count_nodes, "gen_grid_func_and_analytic_derivative", 3 * count_nodes * bytes_node, [&]{
+            auto grid = gen_grid_func_and_analytic_derivative<T>(count_h, none, count_nodes, 1, a, b);
+            return [grid]{ delete[] std::get<0>(grid); delete[] std::get<1>(grid); delete[] std::get<2>(grid); };
+        });
+        // Данные для следующих этапов
+        auto grid_h = gen_grid_func_and_analytic_derivative<T>(count_h, none, count_nodes, 1, a, b);
+        auto grid_h_2 = gen_grid_func_and_analytic_derivative<T>(count_h_2, grid_h, count_h, 2, a, b);
+        const T step_h = (b - a) / (count_h - 1), step_h_2 = (b - a) / (count_h_2 - 1);
+        const T* func_h = std::get<1>(grid_h);
+        const T* func_h_2 = std::get<1>(grid_h_2);
+        const T* analytics_h = std::get<2>(grid_h);
+        const T* analytics_h_2 = std::get<2>(grid_h_2);
+
+        measure_stage(type_name, count_nodes, "gen_derivative_func", 2 * count_nodes * bytes_node, [&]{
+            const T* derivative = gen_derivative_func(func_h, count_h, step_h);
+            return [derivative]{ delete[] derivative; };
+        });
+        const T* derivative_h = gen_derivative_func(func_h, count_h, step_h);
+        const T* derivative_h_2 = gen_derivative_func(func_h_2, count_h_2, step_h_2);
+
+        measure_stage(type_name, count_nodes, "gen_runge_romberg", (count_h_2 + 3 * count_h) * bytes_node, [&]{
+            auto runge = gen_runge_romberg(derivative_h_2, derivative_h, count_h_2, count_h, step_h_2, step_h);
+            return [runge]{ delete[] runge.first; delete[] runge.second; };
+        });
+        auto runge = gen_runge_romberg(derivative_h_2, derivative_h, count_h_2, count_h, step_h_2, step_h);
+
+        measure_stage(type_name, count_nodes, "calculate_norms", 2 * count_nodes * bytes_node, [&]{
+            auto norms = calculate_norms(analytics_h, derivative_h, count_h);
+            return [norms]{ delete[] norms.first; delete[] norms.second; };
+        });
+        measure_stage(type_name, count_nodes, "gen_fused_pipeline", (2 * count_h_2 + 4 * count_h) * bytes_node, [&]{
+            auto result = gen_fused_pipeline(func_h_2, analytics_h_2, count_h_2, step_h_2, Store::All);
+            return [result]{
+                delete[] result.derivative_in_h; delete[] result.derivative_in_h_2;
+                delete[] result.updated_runge; delete[] result.leading_error;
+                delete[] result.errors_in_h.first; delete[] result.errors_in_h.second;
+                delete[] result.errors_in_h_2.first; delete[] result.errors_in_h_2.second;
+                delete[] result.errors_runge.first; delete[] result.errors_runge.second;
+                delete[] result.norms_leading_error;
+            };
+        });
+
+        // Запись: сетка M_viz совпадает с h/2, файл пишется во временную директорию и удаляется
+        Uniform_grid<T> grid_x_h(a, b, count_h), grid_x_h_2(a, b, count_h_2);
+        auto file_size = [](const char* filename) {
+            std::ifstream in(filename, std::ios::binary | std::ios::ate);
+            return static_cast<double>(in.tellg());
+        };
+        for (bool binary : {true, false}){
+            if (!binary && count_nodes > Bench_const::MAX_JSON_NODES) continue;
+            const std::string filename = (std::filesystem::temp_directory_path() / (binary ? "nd_benchmark_data.bin" : "nd_benchmark_data.json")).string();
+            write_data_to_file(grid_x_h_2, grid_x_h, grid_x_h_2, analytics_h_2, derivative_h, derivative_h_2, runge.first, count_h, count_h_2, count_h_2, binary, filename);
+            const double bytes_file = file_size(filename.c_str());
+            measure_stage(type_name, count_nodes, binary ? "write_data_to_file_binary" : "write_data_to_file_json", bytes_file, [&]{
+                write_data_to_file(grid_x_h_2, grid_x_h, grid_x_h_2, analytics_h_2, derivative_h, derivative_h_2, runge.first, count_h, count_h_2, count_h_2, binary, filename);
+                return []{};
+            });
+            std::remove(filename.c_str());
+        }
+
+        delete[] runge.first;
+        delete[] runge.second;
+        delete[] derivative_h;
+        delete[] derivative_h_2;
+        for (auto* grid : {&grid_h, &grid_h_2}){
+            delete[] std::get<0>(*grid);
+            delete[] std::get<1>(*grid);
+            delete[] std::get<2>(*grid);
+        }
+    }
+}
+
+int main(int argc, char** argv){
+    std::size_t max_exponent = 9;
+    double memory_limit_gib = 4.0;
+    try {
+        if (argc > 1) max_exponent = std::stoul(argv[1]);
+        if (argc > 2) memory_limit_gib = std::stod(argv[2]);
+        if (argc > 3) Parallel::thread_count = std::stoul(argv[3]);
+    }
+    catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " [max_exponent=9] [memory_limit_gib=4] [threads=0]\n";
+        return 1;
+    }
+    const double memory_limit_bytes = memory_limit_gib * 1024.0 * 1024.0 * 1024.0;
+
+    std::cout << "type,M,stage,repeats,seconds,ns_per_node,gb_per_s,allocations,bytes_allocated\n";
+    run_benchmark<float>("float", max_exponent, memory_limit_bytes);
+    run_benchmark<double>("double", max_exponent, memory_limit_bytes);
+    run_benchmark<long double>("long double", max_exponent, memory_limit_bytes);
+    return 0;
+}
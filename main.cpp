@@ -4,54 +4,49 @@
 
 using namespace std;
 int main(){
-    std::size_t count_nodes_in_h;
-    std::size_t count_nodes_in_h_2;
-    std::size_t count_nodes_M_viz;
-    //Считаем функции аналитически
-    auto grid_func_der_analytics_in_h = gen_grid_func_and_analytic_derivative<long double>(count_nodes_in_h); //Создаем сетку с шагом h, вычисляем на ней функцию и производную
-    auto grid_func_der_analytics_in_h_2 = gen_grid_func_and_analytic_derivative(count_nodes_in_h_2, grid_func_der_analytics_in_h, count_nodes_in_h, 2); // Измельчаем сетки
-    auto grid_func_der_analytics_in_M_viz = gen_grid_func_and_analytic_derivative(count_nodes_M_viz, grid_func_der_analytics_in_h_2, count_nodes_in_h_2, Task_const::M_viz_ratio);
-    
-    //Распаковываем кортежи
-    auto& [grid_h, func_in_h, derivative_analytics_in_h] = grid_func_der_analytics_in_h;
-    auto& [grid_h_2, func_in_h_2, derivative_analytics_in_h_2] = grid_func_der_analytics_in_h_2;
-    auto& [grid_M_viz, func_in_M_viz, derivative_analytics_in_M_viz] = grid_func_der_analytics_in_M_viz;
+    //Неявные равномерные сетки h, h/2 и M_viz, узлы не хранятся
+    Uniform_grid<long double> grid_h(Task_const::A, Task_const::B, Task_const::M);
+    auto grid_h_2 = grid_h.refined(2);
+    auto grid_M_viz = grid_h_2.refined(Task_const::M_viz_ratio);
 
-    //Считаем производные
-    auto* derivative_in_h = gen_derivative_func(func_in_h, Task_const::M, Task_const::H);
-    auto* derivative_in_h_2 = gen_derivative_func(func_in_h_2, Task_const::M_2, Task_const::STEP_H_2);
-    //Уточняем производную методом Рунге
-    auto runge_leading_error = gen_runge_romberg(derivative_in_h_2, derivative_in_h);
+    //Один буфер на самой мелкой сетке, более редкие сетки - представления с шагом по индексу
+    auto* func_in_M_viz = new long double[grid_M_viz.size()]{};
+    auto* derivative_analytics_in_M_viz = new long double[grid_M_viz.size()]{};
+    Strided_view<long double> func_view{func_in_M_viz, grid_M_viz.size(), 1};
+    Strided_view<long double> derivative_view{derivative_analytics_in_M_viz, grid_M_viz.size(), 1};
+    auto func_in_h_2 = func_view.coarsened(Task_const::M_viz_ratio);
+    auto derivative_analytics_in_h_2 = derivative_view.coarsened(Task_const::M_viz_ratio);
+    auto func_in_h = func_in_h_2.coarsened(2);
+    auto derivative_analytics_in_h = derivative_analytics_in_h_2.coarsened(2);
 
-    auto& [updated_runge, leading_error] = runge_leading_error;
+    //Считаем функции аналитически, при измельчении вычисляются только новые узлы
+    fill_func_and_analytic_derivative(grid_h, func_in_h, derivative_analytics_in_h);
+    fill_func_and_analytic_derivative(grid_h_2, func_in_h_2, derivative_analytics_in_h_2, 2);
+    fill_func_and_analytic_derivative(grid_M_viz, func_view, derivative_view, Task_const::M_viz_ratio);
 
-    //Считаем ошибки
-    auto errors_in_h = calculate_norms(derivative_analytics_in_h, derivative_in_h, Task_const::M);
-    auto errors_in_h_2 = calculate_norms(derivative_analytics_in_h_2, derivative_in_h_2, Task_const::M_2);
-    auto errors_runge = calculate_norms(derivative_analytics_in_h_2, updated_runge, Task_const::M);
-    auto* norms_leading_error = calculate_norms(leading_error, Task_const::M);
+    //Считаем производные на сетках h и h/2, уточняем производную методом Рунге и считаем ошибки за один проход
+    auto pipeline = gen_fused_pipeline<2, long double>(func_in_h_2, derivative_analytics_in_h_2, grid_h_2.step(),
+                                                       Store::Derivative_h | Store::Derivative_h_2 | Store::Runge);
 
-    write_data_to_file(grid_M_viz, grid_h, grid_h_2, derivative_analytics_in_M_viz, derivative_in_h, derivative_in_h_2, updated_runge, Task_const::M, Task_const::M_2, count_nodes_M_viz); 
-    print_error_table(errors_in_h, errors_in_h_2, errors_runge, norms_leading_error);
+    auto& derivative_in_h = pipeline.derivative_in_h;
+    auto& derivative_in_h_2 = pipeline.derivative_in_h_2;
+    auto& updated_runge = pipeline.updated_runge;
+    auto& errors_in_h = pipeline.errors_in_h;
+    auto& errors_in_h_2 = pipeline.errors_in_h_2;
+    auto& errors_runge = pipeline.errors_runge;
+    auto& norms_leading_error = pipeline.norms_leading_error;
 
-    system("python plotter.py");
+    write_data_to_file(grid_M_viz, grid_h, grid_h_2, derivative_analytics_in_M_viz, derivative_in_h, derivative_in_h_2, updated_runge, grid_h.size(), grid_h_2.size(), grid_M_viz.size()); 
+    print_error_table(errors_in_h, errors_in_h_2, errors_runge, norms_leading_error);
 
-    delete[] grid_h_2;
-    delete[] grid_h;
-    delete[] grid_M_viz;
+    system(Task_const::BINARY_OUTPUT ? "python plotter.py data.bin" : "python plotter.py data.json");
 
-    delete[] func_in_h_2;
-    delete[] func_in_h;
     delete[] func_in_M_viz;
-
-    delete[] derivative_analytics_in_h_2;
-    delete[] derivative_analytics_in_h;
     delete[] derivative_analytics_in_M_viz;
 
     delete[] derivative_in_h;
     delete[] derivative_in_h_2;
 
-    delete[] leading_error;
     delete[] updated_runge;
     
     delete[] errors_in_h.first;
@@ -66,4 +61,4 @@ int main(){
     delete[] norms_leading_error;
 
     return 0;
-}
\ No newline at end of file
+}
@@ -1,5 +1,11 @@
 #pragma once
 #include <string>
+#include <tuple>
+#include <utility>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <array>
 
 namespace Task_const {
     /// Редактируемые параметры
@@ -7,6 +13,7 @@ namespace Task_const {
     inline constexpr long double B = 4.0; ///Концы отрезка
     inline constexpr std::size_t M = 30; ///Количество узлов сетки
     inline constexpr std::size_t M_viz_ratio = 20; ///Количество раз, во сколько измельчить сетку, для отображения графика
+    inline constexpr bool BINARY_OUTPUT = true; ///Формат файла результатов (true - двоичный data.bin, false - data.json)
 
     /// Нередактируемые параметры 
     inline constexpr std::size_t M_2 = M*2 - 1; /// Количество узлов сетки h/2
@@ -14,6 +21,158 @@ namespace Task_const {
     inline const long double STEP_H_2 = Task_const::H / 2; /// Шаг сетки h/2 
 }
 
+namespace Task_func {
+    /// Заданная функция и ее аналитическая производная
+    template <typename T> T func(const T x) { return std::sin(x); }
+    template <typename T> T derivative(const T x) { return std::cos(x); }
+}
+namespace Parallel {
+    inline std::size_t thread_count = 0; ///Количество потоков (0 - std::thread::hardware_concurrency(), 1 - последовательно)
+    inline std::size_t min_parallel_nodes = 1 << 16; ///При меньшем количестве узлов вычисления идут последовательно
+    inline constexpr std::size_t chunk_size = 1 << 14; ///Узлов в одном блоке (четное, блок помещается в кэш L2)
+    static_assert(chunk_size % 2 == 0, "chunk_size must be even");
+    inline constexpr std::size_t tile_inner = 512; ///Ширина тайла по непрерывной оси в многомерных ядрах
+    inline constexpr std::size_t batch_block = 64; ///Сигналов (AoS) или узлов (SoA) в блоке пакетного ядра (четное)
+    static_assert(batch_block % 2 == 0, "batch_block must be even");
+}
+namespace Store { // Битовая маска массивов, которые gen_fused_pipeline должен сохранить
+    enum Type : unsigned {
+        None = 0,
+        Derivative_h = 1 << 0,
+        Derivative_h_2 = 1 << 1,
+        Runge = 1 << 2,
+        Leading_error = 1 << 3,
+        All = Derivative_h | Derivative_h_2 | Runge | Leading_error,
+    };
+}
+namespace Layout { // Расположение пакета сигналов в памяти
+    enum Type : unsigned {
+        SoA, // Сигнал за сигналом: data[signal * count_nodes + node]
+        AoS, // Узел за узлом: data[node * count_signals + signal]
+    };
+}
+/**
+ * @brief Равномерная сетка на отрезке [a,b] без хранения узлов, координата вычисляется при обращении
+ * @tparam T Тип данных (float, double, long double).
+ * @note Последний узел всегда равен b, как в gen_uniform_grid
+ */
+template <typename T>
+class Uniform_grid {
+public:
+    Uniform_grid(const T a=Task_const::A, const T b=Task_const::B, const std::size_t count_nodes=Task_const::M)
+        : a_(a), b_(b), count_nodes_(count_nodes), step_(count_nodes > 1 ? (b - a) / (count_nodes - 1) : T(0)) {
+        if (count_nodes < 2) throw std::invalid_argument("Invalid count_nodes values");
+        if ((b - a) < std::numeric_limits<T>::epsilon()) throw std::invalid_argument("Invalid a, b values");
+    }
+    T operator[](const std::size_t i) const { return i + 1 == count_nodes_ ? b_ : a_ + step_ * i; }
+    std::size_t size() const { return count_nodes_; }
+    T step() const { return step_; }
+    T a() const { return a_; }
+    T b() const { return b_; }
+    /// Сетка, измельченная в ratio раз (узлы текущей сетки - каждый ratio-й узел новой)
+    Uniform_grid refined(const std::size_t ratio) const {
+        if (ratio < 1) throw std::invalid_argument("Invalid ratio");
+        return Uniform_grid(a_, b_, count_nodes_ * ratio - (ratio - 1));
+    }
+private:
+    T a_, b_;
+    std::size_t count_nodes_;
+    T step_;
+};
+/**
+ * @brief N-мерная равномерная сетка - прямое произведение одномерных Uniform_grid
+ * @tparam T Тип данных (float, double, long double).
+ * @tparam Dim Размерность
+ * @note Массивы на сетке хранятся построчно: последняя ось непрерывна в памяти, шаг оси k - stride(k)
+ */
+template <typename T, std::size_t Dim>
+class Uniform_grid_nd {
+    static_assert(Dim >= 1, "Dim must be positive");
+public:
+    explicit Uniform_grid_nd(const std::array<Uniform_grid<T>, Dim>& axes) : axes_(axes) {
+        std::size_t stride = 1;
+        for (std::size_t k = Dim; k-- > 0;){
+            strides_[k] = stride;
+            stride *= axes_[k].size();
+        }
+        size_ = stride;
+    }
+    const Uniform_grid<T>& axis(const std::size_t k) const { return axes_[k]; }
+    std::size_t stride(const std::size_t k) const { return strides_[k]; }
+    std::size_t size() const { return size_; }
+    /// Произведение размеров осей до оси k
+    std::size_t count_outer(const std::size_t k) const { return size_ / (strides_[k] * axes_[k].size()); }
+    /// Сетка, измельченная в ratio раз по всем осям
+    Uniform_grid_nd refined(const std::size_t ratio) const {
+        std::array<Uniform_grid<T>, Dim> axes = axes_;
+        for (auto& axis : axes)
+            axis = axis.refined(ratio);
+        return Uniform_grid_nd(axes);
+    }
+private:
+    std::array<Uniform_grid<T>, Dim> axes_;
+    std::array<std::size_t, Dim> strides_{};
+    std::size_t size_ = 0;
+};
+/**
+ * @brief Представление каждого stride-го элемента массива без копирования
+ * @tparam T Тип данных (может быть const)
+ * @note Сетка, в ratio раз более редкая, - это coarsened(ratio) от представления мелкой сетки
+ */
+template <typename T>
+struct Strided_view {
+    T* data = nullptr;
+    std::size_t count = 0;
+    std::size_t stride = 1;
+
+    T& operator[](const std::size_t i) const { return data[i * stride]; }
+    std::size_t size() const { return count; }
+    Strided_view coarsened(const std::size_t ratio) const {
+        if (ratio < 1 || count < 1) throw std::invalid_argument("Invalid ratio");
+        return Strided_view{data, (count - 1) / ratio + 1, stride * ratio};
+    }
+    operator Strided_view<const T>() const { return Strided_view<const T>{data, count, stride}; }
+};
+/// Результат gen_fused_pipeline. Все массивы выделены через new[], освобождает вызывающий
+template <typename T>
+struct Pipeline_result {
+    std::size_t count_nodes_h = 0;
+    std::size_t count_nodes_h_2 = 0;
+    T* derivative_in_h = nullptr; /// Размер count_nodes_h
+    T* derivative_in_h_2 = nullptr; /// Размер count_nodes_h_2
+    T* updated_runge = nullptr; /// Размер count_nodes_h
+    T* leading_error = nullptr; /// Размер count_nodes_h
+    std::pair<T*, T*> errors_in_h{nullptr, nullptr}; /// Нормы (abs, rel), массивы размера Norms::Count
+    std::pair<T*, T*> errors_in_h_2{nullptr, nullptr};
+    std::pair<T*, T*> errors_runge{nullptr, nullptr};
+    T* norms_leading_error = nullptr;
+};
+/// Результат gen_batch_pipeline. Массивы производных - в расположении layout, нормы - count_signals * Norms::Count (по сигналам)
+template <typename T>
+struct Batch_result {
+    std::size_t count_signals = 0;
+    std::size_t count_nodes_h = 0;
+    std::size_t count_nodes_h_2 = 0;
+    Layout::Type layout = Layout::SoA;
+    T* derivative_in_h = nullptr; /// Размер count_signals * count_nodes_h
+    T* derivative_in_h_2 = nullptr; /// Размер count_signals * count_nodes_h_2
+    T* updated_runge = nullptr; /// Размер count_signals * count_nodes_h
+    T* leading_error = nullptr; /// Размер count_signals * count_nodes_h
+    std::pair<T*, T*> errors_in_h{nullptr, nullptr}; /// nullptr, если аналитическая производная не задана
+    std::pair<T*, T*> errors_in_h_2{nullptr, nullptr};
+    std::pair<T*, T*> errors_runge{nullptr, nullptr};
+    T* norms_leading_error = nullptr;
+};
+/// Результат gen_adaptive_romberg. Массивы размера count_nodes выделены через new[], освобождает вызывающий
+template <typename T>
+struct Romberg_result {
+    std::size_t count_nodes = 0;
+    T* derivative = nullptr; /// Уточненная производная (последний элемент строки таблицы)
+    T* leading_error = nullptr; /// Главный член погрешности последнего уточнения
+    std::size_t* levels = nullptr; /// Количество измельчений шага в узле
+    std::size_t count_evaluations = 0; /// Количество вычислений функции
+};
+
 template <typename T>
 std::tuple<T*, T*, T*> gen_grid_func_and_analytic_derivative(
                                     std::size_t& count_nodes_out,
@@ -29,6 +188,8 @@ T* gen_uniform_grid(
                 const T a=Task_const::A, 
                 const T b=Task_const::B
                 );
+template <std::size_t Derivative_order=1, std::size_t Accuracy=2, typename T>
+const T* gen_derivative_func(const T* grid_fun, const std::size_t count_nodes, const T step);
 template <typename T>
 std::pair<T*, T*> gen_runge_romberg(
                         const T* grid_derivative_more_freq, 
@@ -39,25 +200,90 @@ std::pair<T*, T*> gen_runge_romberg(
                         const T step_smaller_freq=Task_const::H
                         );
 
+template <typename T>
+void fill_func_and_analytic_derivative(
+                    const Uniform_grid<T>& grid,
+                    const Strided_view<T>& func,
+                    const Strided_view<T>& derivative,
+                    const std::size_t ratio=1
+                    );
+
 template <typename T>
 void write_to_file_arr(std::ofstream &out, const T *array, std::size_t length, std::string name_array);
 template <typename T>
+void write_to_file_arr(std::ofstream &out, const Uniform_grid<T>& grid, std::string name_array);
+template <typename T>
+void write_to_file_binary(std::ofstream &out, const T *array, std::size_t length);
+template <typename T>
 void write_data_to_file(
-                    const T *grid_M_viz,
-                    const T *grid_h,
-                    const T *grid_h_2,
+                    const Uniform_grid<T>& grid_M_viz,
+                    const Uniform_grid<T>& grid_h,
+                    const Uniform_grid<T>& grid_h_2,
                     const T *derivative_analytics, 
                     const T *derivative_in_h, 
                     const T *derivative_in_h_2, 
                     const T *updated_runge, 
                     const std::size_t count_h_points, 
                     const std::size_t count_h_2_points, 
-                    const std::size_t count_x_points
+                    const std::size_t count_x_points,
+                    const bool binary=Task_const::BINARY_OUTPUT,
+                    const std::string& filename=std::string() // пустое имя: data.bin / data.json по формату
                     );
 template <typename T>
 std::pair<T*,T*> calculate_norms(const T* analytical, const T* numerical, const std::size_t count_nodes);
 template <typename T>
 T* calculate_norms(const T* numerical, const std::size_t count_nodes);
+template <std::size_t Accuracy=2, typename T>
+Pipeline_result<T> gen_fused_pipeline(
+                const T* func_in_h_2,
+                const T* derivative_analytics_in_h_2,
+                const std::size_t count_nodes_h_2=Task_const::M_2,
+                const T step_h_2=Task_const::STEP_H_2,
+                const unsigned store=Store::All
+                );
+template <std::size_t Accuracy=2, typename T>
+Pipeline_result<T> gen_fused_pipeline(
+                const Strided_view<const T>& func_in_h_2,
+                const Strided_view<const T>& derivative_analytics_in_h_2,
+                const T step_h_2,
+                const unsigned store=Store::All
+                );
+template <typename T, typename Func>
+T* gen_batch_func(const Uniform_grid<T>& grid, const std::size_t count_signals, Func&& func, const Layout::Type layout=Layout::SoA);
+template <std::size_t Accuracy=2, typename T>
+Batch_result<T> gen_batch_pipeline(
+                const T* func_in_h_2,
+                const T* derivative_analytics_in_h_2,
+                const std::size_t count_signals,
+                const std::size_t count_nodes_h_2,
+                const T step_h_2,
+                const Layout::Type layout=Layout::SoA,
+                const unsigned store=Store::All
+                );
+template <typename T, typename Func>
+Romberg_result<T> gen_adaptive_romberg(
+                const Uniform_grid<T>& grid,
+                Func&& func,
+                const T tolerance,
+                const std::size_t max_levels=10,
+                const std::size_t interval_nodes=0
+                );
+template <typename T, std::size_t Dim, typename Func>
+T* gen_field_nd(const Uniform_grid_nd<T, Dim>& grid, Func&& func);
+template <std::size_t Derivative_order=1, std::size_t Accuracy=2, typename T, std::size_t Dim>
+T* gen_partial_derivative(const T* field, const Uniform_grid_nd<T, Dim>& grid, const std::size_t axis);
+template <std::size_t Accuracy=2, typename T, std::size_t Dim>
+std::array<T*, Dim> gen_gradient(const T* field, const Uniform_grid_nd<T, Dim>& grid);
+template <std::size_t Accuracy=2, typename T, std::size_t Dim>
+T* gen_laplacian(const T* field, const Uniform_grid_nd<T, Dim>& grid);
+template <typename T, std::size_t Dim>
+std::pair<T*, T*> gen_runge_romberg_nd(
+                const T* derivative_more_freq,
+                const T* derivative_less_freq,
+                const Uniform_grid_nd<T, Dim>& grid_more_freq,
+                const Uniform_grid_nd<T, Dim>& grid_less_freq,
+                const std::size_t accuracy=2
+                );
 template <typename T>
 void print_error_table(
                 const std::pair<T*,T*>& errors_h, 
@@ -5,6 +5,17 @@
 #include <iomanip>
 #include <utility>
 #include <functional>
+#include <type_traits>
+#include <array>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cstdint>
+#include <cstring>
 
 namespace Norms {
     enum Type : std::size_t { // Не вызывает никаких накладных расходов, поскольку на этапе компиляции преобразуется в числа
@@ -14,6 +25,436 @@ namespace Norms {
         Count, // 3 
     };
 }
+/**
+ * @brief Постоянный пул потоков для parallel_for_chunks, потоки создаются один раз и переиспользуются между вызовами
+ * @note Пул только растет до наибольшего запрошенного количества потоков, в вызове участвуют первые count_threads - 1 рабочих.
+ *       Исключение из блока сохраняется, остальные блоки больше не выдаются, после завершения всех потоков
+ *       исключение пробрасывается в вызывающий поток. Вызовы из потока пула выполняются последовательно,
+ *       одновременные вызовы из разных внешних потоков выполняются по очереди.
+ */
+class Thread_pool {
+public:
+    static Thread_pool& instance(){
+        static Thread_pool pool;
+        return pool;
+    }
+    /// true, если текущий поток выполняет блок пула
+    static bool inside(){ return inside_; }
+    /**
+     * @brief Выполнить run_chunk(chunk) для chunk = 0..count_chunks-1 на count_threads потоках (включая текущий)
+     */
+    void run(const std::size_t count_threads, const std::size_t count_chunks, const std::function<void(std::size_t)>& run_chunk){
+        std::lock_guard<std::mutex> run_lock(run_mutex_);
+        grow(count_threads - 1);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = &run_chunk;
+            count_chunks_ = count_chunks;
+            next_chunk_ = 0;
+            stop_ = false;
+            error_ = nullptr;
+            active_ = count_threads - 1;
+            busy_ = active_;
+            generation_++;
+        }
+        start_.notify_all();
+        work(); // Текущий поток тоже работает
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this]{ return busy_ == 0; });
+        job_ = nullptr;
+        if (error_){
+            std::exception_ptr error = error_;
+            error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+    ~Thread_pool(){
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            shutdown_ = true;
+        }
+        start_.notify_all();
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+private:
+    Thread_pool() = default;
+    Thread_pool(const Thread_pool&) = delete;
+    Thread_pool& operator=(const Thread_pool&) = delete;
+
+    void grow(const std::size_t count_workers){ // Добавление недостающих потоков, существующие не пересоздаются
+        for (std::size_t id = workers_.size(); id < count_workers; id++)
+            workers_.emplace_back([this, id, seen = generation_]{ worker_loop(id, seen); });
+    }
+    void worker_loop(const std::size_t id, std::size_t seen){
+        for (;;){
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_.wait(lock, [&]{ return shutdown_ || generation_ != seen; });
+            if (shutdown_) return;
+            seen = generation_;
+            if (id >= active_) continue; // Поток не участвует в этом вызове
+            lock.unlock();
+            work();
+            lock.lock();
+            if (--busy_ == 0) done_.notify_one();
+        }
+    }
+    void work(){ // Разбор блоков по очереди до конца или до первого исключения
+        inside_ = true;
+        for (std::size_t chunk = next_chunk_++; chunk < count_chunks_ && !stop_; chunk = next_chunk_++){
+            try {
+                (*job_)(chunk);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_) error_ = std::current_exception();
+                stop_ = true;
+            }
+        }
+        inside_ = false;
+    }
+
+    static inline thread_local bool inside_ = false;
+    std::mutex run_mutex_; // Одно задание в пуле одновременно
+    std::mutex mutex_;
+    std::condition_variable start_, done_;
+    std::vector<std::thread> workers_;
+    const std::function<void(std::size_t)>* job_ = nullptr;
+    std::size_t count_chunks_ = 0;
+    std::atomic<std::size_t> next_chunk_{0};
+    std::atomic<bool> stop_{false};
+    std::exception_ptr error_;
+    std::size_t active_ = 0; // Рабочих потоков, участвующих в текущем вызове
+    std::size_t busy_ = 0;
+    std::size_t generation_ = 0;
+    bool shutdown_ = false;
+};
+/**
+ * @brief Обход диапазона [0, count) блоками Parallel::chunk_size узлов на нескольких потоках
+ * @param count Количество элементов
+ * @param body Функция body(chunk_index, begin, end), вызывается один раз для каждого блока
+ * @param chunk_size Элементов в блоке (По умолчанию Parallel::chunk_size)
+ * @param node_weight Узлов сетки, обрабатываемых на один элемент, например длина линии в ND-ядрах (По умолчанию 1)
+ * @note Разбиение на блоки не зависит от количества потоков, поэтому редукции по блокам детерминированы.
+ *       При count * node_weight < Parallel::min_parallel_nodes, одном потоке или вызове из потока пула блоки обходятся последовательно.
+ *       Блоки выполняются постоянным пулом Thread_pool, исключение из body пробрасывается вызывающему.
+ */
+template <typename Func>
+void parallel_for_chunks(const std::size_t count, Func&& body, const std::size_t chunk_size=Parallel::chunk_size, const std::size_t node_weight=1){
+    const std::size_t count_chunks = (count + chunk_size - 1) / chunk_size;
+    std::size_t count_threads = Parallel::thread_count;
+    if (count_threads == 0) count_threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    count_threads = std::min(count_threads, count_chunks);
+
+    auto run_chunk = [&](std::size_t chunk){
+        std::size_t begin = chunk * chunk_size;
+        body(chunk, begin, std::min(begin + chunk_size, count));
+    };
+    if (count_threads <= 1 || count * node_weight < Parallel::min_parallel_nodes || Thread_pool::inside()){ // Последовательный режим
+        for (std::size_t chunk = 0; chunk < count_chunks; chunk++)
+            run_chunk(chunk);
+        return;
+    }
+    Thread_pool::instance().run(count_threads, count_chunks, run_chunk);
+}
+/**
+ * @brief Обход пакета сигналов блоками (Parallel::batch_block сигналов) x (Parallel::chunk_size узлов) на нескольких потоках
+ * @param count_signals Количество сигналов
+ * @param count_nodes Количество узлов сетки
+ * @param body Функция body(chunk, s_begin, s_end, begin, end), вызывается один раз для каждой пары (блок сигналов, блок узлов chunk)
+ * @note Пакет из многих сигналов на короткой сетке распределяется по потокам по сигналам.
+ *       Блоки узлов те же, что в parallel_for_chunks, поэтому частичные суммы по (chunk, сигнал) детерминированы.
+ */
+template <typename Func>
+void parallel_for_batch(const std::size_t count_signals, const std::size_t count_nodes, Func&& body){
+    const std::size_t count_blocks = (count_signals + Parallel::batch_block - 1) / Parallel::batch_block;
+    const std::size_t count_chunks = (count_nodes + Parallel::chunk_size - 1) / Parallel::chunk_size;
+    const std::size_t count_tasks = count_blocks * count_chunks;
+    parallel_for_chunks(count_tasks, [&](std::size_t task, std::size_t, std::size_t){
+        const std::size_t chunk = task / count_blocks;
+        const std::size_t s_begin = task % count_blocks * Parallel::batch_block;
+        const std::size_t begin = chunk * Parallel::chunk_size;
+        body(chunk, s_begin, std::min(s_begin + Parallel::batch_block, count_signals), begin, std::min(begin + Parallel::chunk_size, count_nodes));
+    }, 1, count_signals * count_nodes / count_tasks + 1);
+}
+/**
+ * @brief Вычисление весов конечно-разностной формулы по алгоритму Форнберга (на этапе компиляции)
+ * @tparam Derivative_order Порядок производной
+ * @tparam Count_points Количество узлов шаблона
+ * @param nodes Координаты узлов шаблона в единицах шага
+ * @param x0 Точка, в которой вычисляется производная (в единицах шага)
+ * @return Массив весов, производная = сумма(w_k * f_k) / step^Derivative_order
+ */
+template <std::size_t Derivative_order, std::size_t Count_points>
+constexpr std::array<long double, Count_points> fornberg_weights(const std::array<long double, Count_points>& nodes, const long double x0){
+    std::array<std::array<long double, Derivative_order + 1>, Count_points> c{}; // c[j][k] - вес узла j для производной порядка k
+    long double c1 = 1.0, c4 = nodes[0] - x0;
+    c[0][0] = 1.0;
+    for (std::size_t i = 1; i < Count_points; i++){
+        std::size_t mn = i < Derivative_order ? i : Derivative_order;
+        long double c2 = 1.0, c5 = c4;
+        c4 = nodes[i] - x0;
+        for (std::size_t j = 0; j < i; j++){
+            long double c3 = nodes[i] - nodes[j];
+            c2 *= c3;
+            if (j == i - 1){
+                for (std::size_t k = mn; k >= 1; k--)
+                    c[i][k] = c1 * (k * c[i-1][k-1] - c5 * c[i-1][k]) / c2;
+                c[i][0] = -c1 * c5 * c[i-1][0] / c2;
+            }
+            for (std::size_t k = mn; k >= 1; k--)
+                c[j][k] = (c4 * c[j][k] - k * c[j][k-1]) / c3;
+            c[j][0] = c4 * c[j][0] / c3;
+        }
+        c1 = c2;
+    }
+    std::array<long double, Count_points> weights{};
+    for (std::size_t j = 0; j < Count_points; j++)
+        weights[j] = c[j][Derivative_order];
+    return weights;
+}
+/**
+ * @brief Конечно-разностный шаблон, коэффициенты которого вычисляются на этапе компиляции
+ * @tparam T Тип данных (float, double, long double).
+ * @tparam Derivative_order Порядок производной
+ * @tparam Accuracy Порядок точности (четный)
+ * @note Во внутренних узлах используется центральный шаблон, в первых и последних half_width узлах - односторонние
+ */
+template <typename T, std::size_t Derivative_order, std::size_t Accuracy>
+struct Stencil {
+    static_assert(Derivative_order >= 1, "Derivative order must be positive");
+    static_assert(Accuracy >= 2 && Accuracy % 2 == 0, "Accuracy must be even and >= 2");
+
+    static constexpr std::size_t half_width = (Derivative_order + 1) / 2 - 1 + Accuracy / 2; // Полуширина центрального шаблона
+    static constexpr std::size_t central_size = 2 * half_width + 1;
+    static constexpr std::size_t one_sided_size = Derivative_order + Accuracy;
+    static constexpr std::size_t min_count_nodes = central_size > one_sided_size ? central_size : one_sided_size;
+
+    static constexpr std::array<T, central_size> gen_central(){
+        std::array<long double, central_size> nodes{};
+        for (std::size_t k = 0; k < central_size; k++)
+            nodes[k] = static_cast<long double>(k) - static_cast<long double>(half_width);
+        auto weights = fornberg_weights<Derivative_order>(nodes, 0.0L);
+        std::array<T, central_size> result{};
+        for (std::size_t k = 0; k < central_size; k++)
+            result[k] = static_cast<T>(weights[k]);
+        return result;
+    }
+    static constexpr std::array<std::array<T, one_sided_size>, half_width> gen_left(){ // Шаблон для узла i по узлам 0..one_sided_size-1
+        std::array<long double, one_sided_size> nodes{};
+        for (std::size_t k = 0; k < one_sided_size; k++)
+            nodes[k] = static_cast<long double>(k);
+        std::array<std::array<T, one_sided_size>, half_width> result{};
+        for (std::size_t i = 0; i < half_width; i++){
+            auto weights = fornberg_weights<Derivative_order>(nodes, static_cast<long double>(i));
+            for (std::size_t k = 0; k < one_sided_size; k++)
+                result[i][k] = static_cast<T>(weights[k]);
+        }
+        return result;
+    }
+
+    static constexpr std::array<T, central_size> central = gen_central();
+    static constexpr std::array<std::array<T, one_sided_size>, half_width> left = gen_left();
+    // Правые шаблоны - зеркальные левые, умноженные на (-1)^Derivative_order
+    static constexpr T right_sign = Derivative_order % 2 == 0 ? T(1) : T(-1);
+};
+
+/**
+ * Внутренний цикл центрального шаблона: dst[i] = scale * sum_k(w[k] * src[i + k]), i = 0..count-1.
+ * Для float и double есть копии, собранные под AVX2 и AVX-512F, копия выбирается во время выполнения
+ * по __builtin_cpu_supports (GCC/Clang, x86). Порядок суммирования по k одинаков во всех копиях,
+ * сжатие в FMA отключено (AVX-512F его включает), поэтому результат не зависит от выбранной копии.
+ * Векторизация работает только с оптимизацией (Release, -O3).
+ */
+#define ND_STENCIL_INTERIOR_LOOP                         \
+    for (std::size_t i = 0; i < count; i++){            \
+        T sum = 0;                                      \
+        for (std::size_t k = 0; k < Size; k++)          \
+            sum += w[k] * src[i + k];                   \
+        dst[i] = sum * scale;                           \
+    }
+
+#if defined(__clang__)
+#define ND_NO_FP_CONTRACT
+#define ND_NO_FP_CONTRACT_PRAGMA _Pragma("clang fp contract(off)")
+#define ND_TARGET_AVX512 __attribute__((target("avx512f")))
+#elif defined(__GNUC__)
+#define ND_NO_FP_CONTRACT __attribute__((optimize("fp-contract=off")))
+#define ND_NO_FP_CONTRACT_PRAGMA
+#define ND_TARGET_AVX512 __attribute__((target("avx512f,prefer-vector-width=512")))
+#else
+#define ND_NO_FP_CONTRACT
+#define ND_NO_FP_CONTRACT_PRAGMA
+#endif
+
+template <std::size_t Size, typename T>
+ND_NO_FP_CONTRACT
+void stencil_interior_generic(const T* w, const T* src, T* dst, const std::size_t count, const T scale){
+    ND_NO_FP_CONTRACT_PRAGMA
+    ND_STENCIL_INTERIOR_LOOP
+}
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ND_SIMD_DISPATCH 1
+template <std::size_t Size, typename T>
+__attribute__((target("avx2"))) ND_NO_FP_CONTRACT
+void stencil_interior_avx2(const T* w, const T* src, T* dst, const std::size_t count, const T scale){
+    ND_NO_FP_CONTRACT_PRAGMA
+    ND_STENCIL_INTERIOR_LOOP
+}
+template <std::size_t Size, typename T>
+ND_TARGET_AVX512 ND_NO_FP_CONTRACT
+void stencil_interior_avx512(const T* w, const T* src, T* dst, const std::size_t count, const T scale){
+    ND_NO_FP_CONTRACT_PRAGMA
+    ND_STENCIL_INTERIOR_LOOP
+}
+namespace Simd {
+    enum Level { Generic, Avx2, Avx512 };
+    inline Level detect_level(){ // Определяется один раз при первом вызове
+        static const Level level = [] {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) return Avx512;
+            if (__builtin_cpu_supports("avx2")) return Avx2;
+            return Generic;
+        }();
+        return level;
+    }
+}
+#endif
+#undef ND_STENCIL_INTERIOR_LOOP
+
+/**
+ * @brief Выбор копии внутреннего цикла центрального шаблона под набор инструкций процессора
+ * @tparam Size Длина шаблона
+ * @tparam T Тип данных, для long double всегда используется обычная копия
+ */
+template <std::size_t Size, typename T>
+void stencil_interior(const T* w, const T* src, T* dst, const std::size_t count, const T scale){
+#ifdef ND_SIMD_DISPATCH
+    if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>){
+        switch (Simd::detect_level()){
+            case Simd::Avx512: stencil_interior_avx512<Size>(w, src, dst, count, scale); return;
+            case Simd::Avx2: stencil_interior_avx2<Size>(w, src, dst, count, scale); return;
+            default: break;
+        }
+    }
+#endif
+    stencil_interior_generic<Size>(w, src, dst, count, scale);
+}
+
+/**
+ * @brief Накопитель сумм для норм L_1, L_2, L_inf, позволяет считать нормы за один проход вместе с другими вычислениями
+ * @tparam T Тип данных (float, double, long double).
+ */
+template <typename T>
+struct Norm_accumulator {
+    T sum_abs = 0.0, sum_2_abs = 0.0, max_abs = 0.0;
+    T sum_rel = 0.0, sum_2_rel = 0.0, max_rel = 0.0;
+
+    void add(const T analytical, const T numerical) { // Ошибка относительно аналитического значения
+        T abs_error = std::abs(analytical - numerical);
+        sum_abs += abs_error;
+        sum_2_abs += abs_error * abs_error;
+        max_abs = std::max(max_abs, abs_error);
+        if (std::abs(analytical) > std::numeric_limits<T>::epsilon()){
+            T rel_error = abs_error / std::abs(analytical);
+            sum_rel += rel_error;
+            sum_2_rel += rel_error * rel_error;
+            max_rel = std::max(max_rel, rel_error);
+        }
+    }
+    void add(const T value) { // Норма самого значения
+        T abs_value = std::abs(value);
+        sum_abs += abs_value;
+        sum_2_abs += abs_value * abs_value;
+        max_abs = std::max(max_abs, abs_value);
+    }
+    void merge(const Norm_accumulator& other) { // Объединение частичных сумм блоков
+        sum_abs += other.sum_abs;
+        sum_2_abs += other.sum_2_abs;
+        max_abs = std::max(max_abs, other.max_abs);
+        sum_rel += other.sum_rel;
+        sum_2_rel += other.sum_2_rel;
+        max_rel = std::max(max_rel, other.max_rel);
+    }
+    T* norms_abs() const { // Массив размера Norms::Count
+        T* norms = new T[Norms::Count]{};
+        norms[Norms::L_1] = sum_abs;
+        norms[Norms::L_2] = std::sqrt(sum_2_abs);
+        norms[Norms::L_inf] = max_abs;
+        return norms;
+    }
+    T* norms_rel() const { // Массив размера Norms::Count
+        T* norms = new T[Norms::Count]{};
+        norms[Norms::L_1] = sum_rel;
+        norms[Norms::L_2] = std::sqrt(sum_2_rel);
+        norms[Norms::L_inf] = max_rel;
+        return norms;
+    }
+};
+/**
+ * @brief Накопители норм для блока из Parallel::batch_block сигналов: каждая сумма - отдельный массив, индекс - сигнал в блоке
+ * @tparam T Тип данных (float, double, long double).
+ * @note Циклы по сигналам без ветвлений, поэтому векторизуются. Порядок сложений для каждого сигнала тот же, что в Norm_accumulator.
+ */
+template <typename T>
+struct Norm_block_accumulator {
+    static constexpr std::size_t block = Parallel::batch_block;
+    T sum_abs[block]{}, sum_2_abs[block]{}, max_abs[block]{};
+    T sum_rel[block]{}, sum_2_rel[block]{}, max_rel[block]{};
+
+    void add(const T* analytical, const T* numerical, const std::size_t count) {
+        for (std::size_t k = 0; k < count; k++){
+            const T abs_error = std::abs(analytical[k] - numerical[k]);
+            sum_abs[k] += abs_error;
+            sum_2_abs[k] += abs_error * abs_error;
+            max_abs[k] = std::max(max_abs[k], abs_error);
+            // Условие Norm_accumulator::add заменено маской 0/1: прибавление нуля не меняет сумм,
+            // при mask = 1 делитель равен |analytical| точно, деление без ветвления векторизуется
+            const T abs_analytical = std::abs(analytical[k]);
+            const T mask = abs_analytical > std::numeric_limits<T>::epsilon() ? T(1) : T(0);
+            const T rel_error = abs_error / (abs_analytical + (T(1) - mask)) * mask;
+            sum_rel[k] += rel_error;
+            sum_2_rel[k] += rel_error * rel_error;
+            max_rel[k] = std::max(max_rel[k], rel_error);
+        }
+    }
+    void add(const T* value, const std::size_t count) {
+        for (std::size_t k = 0; k < count; k++){
+            const T abs_value = std::abs(value[k]);
+            sum_abs[k] += abs_value;
+            sum_2_abs[k] += abs_value * abs_value;
+            max_abs[k] = std::max(max_abs[k], abs_value);
+        }
+    }
+    Norm_accumulator<T> get(const std::size_t k) const { // Накопитель сигнала k
+        Norm_accumulator<T> acc;
+        acc.sum_abs = sum_abs[k]; acc.sum_2_abs = sum_2_abs[k]; acc.max_abs = max_abs[k];
+        acc.sum_rel = sum_rel[k]; acc.sum_2_rel = sum_2_rel[k]; acc.max_rel = max_rel[k];
+        return acc;
+    }
+};
+/**
+ * @brief Детерминированная параллельная редукция норм: частичные суммы по блокам объединяются в порядке блоков
+ * @tparam T Тип данных (float, double, long double).
+ * @tparam Count_acc Количество одновременно накапливаемых норм
+ * @param count Количество элементов
+ * @param body Функция body(accumulators, begin, end), накапливает нормы по диапазону [begin, end)
+ * @return Массив из Count_acc накопителей, результат не зависит от количества потоков
+ */
+template <typename T, std::size_t Count_acc = 1, typename Func>
+std::array<Norm_accumulator<T>, Count_acc> parallel_reduce_norms(const std::size_t count, Func&& body){
+    using Accs = std::array<Norm_accumulator<T>, Count_acc>;
+    std::vector<Accs> partial((count + Parallel::chunk_size - 1) / Parallel::chunk_size);
+    parallel_for_chunks(count, [&](std::size_t chunk, std::size_t begin, std::size_t end){
+        body(partial[chunk], begin, end);
+    });
+    Accs total{};
+    for (const auto& accs : partial)
+        for (std::size_t k = 0; k < Count_acc; k++)
+            total[k].merge(accs[k]);
+    return total;
+}
 /**
  * @brief Функция для генерации или измельчения массива значений заданной функции на отрезке и вычисления аналитической производной
  * @tparam T Тип данных (float, double, long double).
@@ -44,8 +485,8 @@ std::tuple<T*, T*, T*> gen_grid_func_and_analytic_derivative(
     T* grid_x = nullptr; // Массив сетки
     T* arr_func = nullptr; // Массив значений функции на сетке
     T* arr_derivative = nullptr; // Массив значений производной
-    static auto func = [](T x) -> T {return std::sin(x); }; // Заданная функция
-    static auto der = [](T x) -> T {return std::cos(x); }; // Аналитическая производная
+    static auto func = [](T x) -> T {return Task_func::func(x); }; // Заданная функция
+    static auto der = [](T x) -> T {return Task_func::derivative(x); }; // Аналитическая производная
 
     //Функция для измельчения сетки x
     static auto gen_grinded_grid = [](T* grid_rare, std::size_t count_nodes_grinded, std::size_t count_nodes_rare, std::size_t ratio, T step) {
@@ -65,10 +506,12 @@ std::tuple<T*, T*, T*> gen_grid_func_and_analytic_derivative(
         grid_x = gen_uniform_grid(step, count_nodes_out, a, b); // Создаем сетку на оси x
         arr_func = new T[count_nodes_out]{};
         arr_derivative = new T[count_nodes_out]{};
-        for (std::size_t i = 0; i < count_nodes_out; i++){
-            arr_func[i] = func(grid_x[i]); //заданная функция
-            arr_derivative[i] = der(grid_x[i]); //аналитическая производная
-        }
+        parallel_for_chunks(count_nodes_out, [&](std::size_t, std::size_t begin, std::size_t end){
+            for (std::size_t i = begin; i < end; i++){
+                arr_func[i] = func(grid_x[i]); //заданная функция
+                arr_derivative[i] = der(grid_x[i]); //аналитическая производная
+            }
+        });
     }
     else { // Массив старой сетки существует, нужно измельчить сетку функции
         count_nodes_out = count_nodes_init * ratio - (ratio - 1); // Проверяется на листке бумаги
@@ -76,20 +519,51 @@ std::tuple<T*, T*, T*> gen_grid_func_and_analytic_derivative(
         grid_x = gen_grinded_grid(x_rare, count_nodes_out, count_nodes_init, ratio, step);// Измельчаем сетку x
         arr_func = new T[count_nodes_out]{};
         arr_derivative = new T[count_nodes_out]{};
-        for(std::size_t i = 0; i < count_nodes_init - 1; i++) {
-            arr_func[ratio * i] = func_rare[i]; // Старая точка
-            arr_derivative[ratio * i] = derivative_rare[i]; //Старая точка
-            for(std::size_t j = 1; j < ratio; j++) { // Промежуточные значения
-                arr_func[ratio * i + j] = func(grid_x[ratio * i + j]);
-                arr_derivative[ratio * i + j] = der(grid_x[ratio * i + j]);
+        parallel_for_chunks(count_nodes_init - 1, [&](std::size_t, std::size_t begin, std::size_t end){ // Блоки по старой сетке
+            for(std::size_t i = begin; i < end; i++) {
+                arr_func[ratio * i] = func_rare[i]; // Старая точка
+                arr_derivative[ratio * i] = derivative_rare[i]; //Старая точка
+                for(std::size_t j = 1; j < ratio; j++) { // Промежуточные значения
+                    arr_func[ratio * i + j] = func(grid_x[ratio * i + j]);
+                    arr_derivative[ratio * i + j] = der(grid_x[ratio * i + j]);
+                }
             }
-        }
+        });
         arr_func[count_nodes_out - 1] = func_rare[count_nodes_init - 1]; // Последняя точка
         arr_derivative[count_nodes_out - 1] = derivative_rare[count_nodes_init - 1];
     }
     
     return std::make_tuple(grid_x, arr_func, arr_derivative);
 }
+/**
+ * @brief Функция для вычисления заданной функции и аналитической производной на неявной равномерной сетке
+ * @tparam T Тип данных (float, double, long double).
+ * @param grid Равномерная сетка
+ * @param[out] func Представление массива функции размера grid.size() (Выходной параметр)
+ * @param[out] derivative Представление массива производной размера grid.size() (Выходной параметр)
+ * @param ratio Узлы с индексом, кратным ratio, уже заполнены на более редкой сетке и пропускаются (По умолчанию = 1, заполняются все узлы)
+ * @note При измельчении вычисляются только новые узлы, старые значения остаются на месте в общем буфере
+ */
+template <typename T>
+void fill_func_and_analytic_derivative(
+                    const Uniform_grid<T>& grid,
+                    const Strided_view<T>& func,
+                    const Strided_view<T>& derivative,
+                    const std::size_t ratio
+                    ){
+    if (func.data == nullptr || derivative.data == nullptr) throw std::invalid_argument("Input arrays cannot be null.");
+    if (func.size() != grid.size() || derivative.size() != grid.size()) throw std::invalid_argument("Invalid count_nodes");
+    if (ratio < 1 || (grid.size() - 1) % ratio != 0) throw std::invalid_argument("Invalid ratio");
+
+    parallel_for_chunks(grid.size(), [&](std::size_t, std::size_t begin, std::size_t end){
+        for (std::size_t i = begin; i < end; i++){
+            if (ratio != 1 && i % ratio == 0) continue; // Старая точка
+            T x = grid[i];
+            func[i] = Task_func::func(x);
+            derivative[i] = Task_func::derivative(x);
+        }
+    });
+}
 /**
  * @brief Функция для генерации равномерной сетки на отрезке [a,b]
  * @tparam T Тип данных (float, double, long double).
@@ -106,8 +580,10 @@ T* gen_uniform_grid(const T step, const std::size_t count_nodes, const T a, cons
     if ((b - a) < std::numeric_limits<T>::epsilon()) throw std::invalid_argument("Invalid a, b values");
 
     T* array = new T[count_nodes]{}; 
-    for (std::size_t i = 0; i < count_nodes; i++) 
-        array[i] = a + step * i; // Заполняем значения, включая последний узел, равный b
+    parallel_for_chunks(count_nodes, [&](std::size_t, std::size_t begin, std::size_t end){
+        for (std::size_t i = begin; i < end; i++) 
+            array[i] = a + step * i; // Заполняем значения, включая последний узел, равный b
+    });
     if (array[count_nodes - 1] != b)
         array[count_nodes - 1] = b;
     
@@ -116,24 +592,45 @@ T* gen_uniform_grid(const T step, const std::size_t count_nodes, const T a, cons
 
 /**
  * @brief Функция для вычисления производной функции 
+ * @tparam Derivative_order Порядок производной (По умолчанию 1)
+ * @tparam Accuracy Порядок точности шаблона, четный (По умолчанию 2)
  * @tparam T Тип данных (float, double, long double).
  * @param grid_fun - Массив функции.
  * @param count_nodes - Количество узлов сетки
  * @param step - Шаг сетки
  * @return T* Указатель на массив производной функции.
- * @note Массив имеет размер count_nodes.
+ * @note Массив имеет размер count_nodes. Коэффициенты шаблона вычисляются на этапе компиляции (Stencil),
+ *       внутренний цикл для float/double выполняется копией под AVX2/AVX-512, выбранной во время выполнения (stencil_interior).
  */
-template <typename T>
+template <std::size_t Derivative_order, std::size_t Accuracy, typename T>
 const T* gen_derivative_func(const T* grid_fun, const std::size_t count_nodes, const T step){
+    using St = Stencil<T, Derivative_order, Accuracy>;
     if (grid_fun == nullptr) throw std::invalid_argument("grid_fun is null");
-    if (count_nodes < 2) throw std::invalid_argument("Invalid count_nodes");
+    if (count_nodes < St::min_count_nodes) throw std::invalid_argument("Invalid count_nodes");
+    if (step <= 0) throw std::invalid_argument("Invalid step");
+
+    T inv_step = 1; // 1 / step^Derivative_order, чтобы не делить в каждом узле
+    for (std::size_t k = 0; k < Derivative_order; k++)
+        inv_step /= step;
 
     T* grid_derivative = new T[count_nodes]{};
-    grid_derivative[0] = (-3.0*grid_fun[0] + 4.0*grid_fun[1] - grid_fun[2]) / (2.0 * step); //Формула для самой левой точки
-    for (std::size_t i = 1; i < count_nodes - 1; i++){
-        grid_derivative[i] = (grid_fun[i + 1] - grid_fun[i - 1]) / (2 * step); //Формула центральных разностей
+    constexpr auto central = St::central;
+    constexpr auto left = St::left;
+    constexpr std::size_t hw = St::half_width;
+    constexpr std::size_t os = St::one_sided_size;
+    for (std::size_t i = 0; i < hw; i++){ // Односторонние формулы для крайних узлов
+        T sum_left = 0, sum_right = 0;
+        for (std::size_t k = 0; k < os; k++){
+            sum_left += left[i][k] * grid_fun[k];
+            sum_right += left[i][k] * grid_fun[count_nodes - 1 - k];
+        }
+        grid_derivative[i] = sum_left * inv_step;
+        grid_derivative[count_nodes - 1 - i] = St::right_sign * sum_right * inv_step;
     }
-    grid_derivative[count_nodes-1] = (3.0*grid_fun[count_nodes-1] - 4.0*grid_fun[count_nodes-2] + grid_fun[count_nodes-3]) / (2.0 * step);
+    // Центральный шаблон, блоки читают соседние узлы (halo) напрямую из общего входного массива
+    parallel_for_chunks(count_nodes - 2 * hw, [&](std::size_t, std::size_t begin, std::size_t end){
+        stencil_interior<St::central_size>(central.data(), grid_fun + begin, grid_derivative + hw + begin, end - begin, inv_step);
+    });
     return grid_derivative;
 }
 /**
@@ -196,37 +693,187 @@ void write_to_file_arr(std::ofstream &out, const T *array, std::size_t length, s
     }
     out << "]";
 }
+/**
+ * Двоичный формат data.bin (little-endian), читается plotter.py через numpy.memmap без разбора текста:
+ *   [0, 8)    магическая строка "NDIFFBIN"
+ *   [8, 12)   uint32 версия формата (1)
+ *   [12, 16)  uint32 количество массивов count
+ *   [16, ...) count записей по 64 байта: char name[40], char dtype[8] ("<f4", "<f8" или "grid"), uint64 offset, uint64 length
+ *   далее     данные массивов, каждый начинается со смещения offset, кратного 64 байтам
+ * Массив dtype "grid" - неявная равномерная сетка из length узлов, данные - два "<f8" (a, b).
+ * long double записывается как "<f8", поскольку его двоичное представление зависит от платформы.
+ */
+namespace Binary_format {
+    inline constexpr char MAGIC[8] = {'N', 'D', 'I', 'F', 'F', 'B', 'I', 'N'};
+    inline constexpr std::uint32_t VERSION = 1;
+    inline constexpr std::size_t NAME_SIZE = 40;
+    inline constexpr std::size_t DTYPE_SIZE = 8;
+    inline constexpr std::size_t ENTRY_SIZE = 64;
+    inline constexpr std::size_t ALIGNMENT = 64;
+    inline constexpr std::size_t HEADER_SIZE = 16;
+    inline constexpr std::size_t BUFFER_SIZE = 1 << 20; // Буфер потока и блок преобразования long double
+
+    template <typename T> struct Dtype; // Тип, в котором элементы T хранятся в файле
+    template <> struct Dtype<float> { using stored = float; static constexpr const char* name = "<f4"; };
+    template <> struct Dtype<double> { using stored = double; static constexpr const char* name = "<f8"; };
+    template <> struct Dtype<long double> { using stored = double; static constexpr const char* name = "<f8"; };
+
+    struct Entry { // Запись таблицы заголовка
+        std::string name;
+        std::string dtype;
+        std::uint64_t length;
+        std::uint64_t size_bytes;
+        std::function<void(std::ofstream&)> write;
+    };
+}
+/**
+ * @brief Функция для записи массива в двоичный файл подряд, без форматирования
+ * @tparam T Тип данных (float, double, long double).
+ * @param out Указатель на поток ввода (открыт в режиме binary).
+ * @param array Массив.
+ * @param length Длина массива.
+ * @note float и double записываются одним вызовом write, long double преобразуется в double блоками
+ */
+template <typename T>
+void write_to_file_binary(std::ofstream &out, const T *array, std::size_t length){
+	if (array == nullptr || length == 0) throw std::invalid_argument("Array is null or length is zero");
+    using Stored = typename Binary_format::Dtype<T>::stored;
+    if constexpr (std::is_same_v<Stored, T>){
+        out.write(reinterpret_cast<const char*>(array), static_cast<std::streamsize>(length * sizeof(T)));
+    }
+    else {
+        constexpr std::size_t block = Binary_format::BUFFER_SIZE / sizeof(Stored);
+        std::vector<Stored> buffer(std::min(block, length));
+        for (std::size_t begin = 0; begin < length; begin += block){
+            std::size_t count = std::min(block, length - begin);
+            for (std::size_t i = 0; i < count; i++)
+                buffer[i] = static_cast<Stored>(array[begin + i]);
+            out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(count * sizeof(Stored)));
+        }
+    }
+}
+/**
+ * @brief Функция для записи таблицы массивов в двоичный файл в формате Binary_format
+ * @param filename Имя файла
+ * @param entries Записи таблицы, смещения вычисляются здесь
+ */
+inline void write_binary_file(const std::string& filename, const std::vector<Binary_format::Entry>& entries){
+    std::vector<char> stream_buffer(Binary_format::BUFFER_SIZE);
+    std::ofstream out;
+    out.rdbuf()->pubsetbuf(stream_buffer.data(), static_cast<std::streamsize>(stream_buffer.size())); // До открытия файла
+    out.open(filename, std::ios::binary);
+	if (!out.is_open()) throw std::runtime_error("Cant open file");
+
+    static auto align = [](std::uint64_t offset) {
+        return (offset + Binary_format::ALIGNMENT - 1) / Binary_format::ALIGNMENT * Binary_format::ALIGNMENT;
+    };
+    static auto write_u32 = [](std::ofstream& out, std::uint32_t value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    static auto write_u64 = [](std::ofstream& out, std::uint64_t value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    static auto write_padded = [](std::ofstream& out, const std::string& text, std::size_t size) {
+        if (text.size() >= size) throw std::invalid_argument("Name is too long");
+        std::vector<char> field(size, '\0');
+        std::memcpy(field.data(), text.data(), text.size());
+        out.write(field.data(), static_cast<std::streamsize>(size));
+    };
+
+    out.write(Binary_format::MAGIC, sizeof(Binary_format::MAGIC));
+    write_u32(out, Binary_format::VERSION);
+    write_u32(out, static_cast<std::uint32_t>(entries.size()));
+    std::vector<std::uint64_t> offsets(entries.size());
+    std::uint64_t offset = align(Binary_format::HEADER_SIZE + entries.size() * Binary_format::ENTRY_SIZE);
+    for (std::size_t k = 0; k < entries.size(); k++){ // Таблица
+        offsets[k] = offset;
+        write_padded(out, entries[k].name, Binary_format::NAME_SIZE);
+        write_padded(out, entries[k].dtype, Binary_format::DTYPE_SIZE);
+        write_u64(out, offsets[k]);
+        write_u64(out, entries[k].length);
+        offset = align(offset + entries[k].size_bytes);
+    }
+    for (std::size_t k = 0; k < entries.size(); k++){ // Данные
+        std::uint64_t position = static_cast<std::uint64_t>(out.tellp());
+        if (position < offsets[k]){
+            std::vector<char> padding(offsets[k] - position, '\0');
+            out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+        }
+        entries[k].write(out);
+    }
+    if (!out) throw std::runtime_error("Cant write file");
+    out.close();
+}
+/**
+ * @brief Функция для записи узлов неявной сетки в файл в формате json, аналогично write_to_file_arr для массива
+ * @tparam T Тип данных (float, double, long double).
+ * @param out Указатель на поток ввода.
+ * @param grid Равномерная сетка.
+ * @param name_array Имя массива.
+ */
+template <typename T>
+void write_to_file_arr(std::ofstream &out, const Uniform_grid<T>& grid, std::string name_array){
+ 	out << "\"" << name_array << "\"" << ": [";
+    for (std::size_t i = 0; i < grid.size(); i++) {
+        out << grid[i];
+        if (i != grid.size() - 1) 
+			out << ", ";
+    }
+    out << "]";
+}
 template <typename T>
 void write_data_to_file(
-                    const T *grid_M_viz,
-                    const T *grid_h,
-                    const T *grid_h_2,
+                    const Uniform_grid<T>& grid_M_viz,
+                    const Uniform_grid<T>& grid_h,
+                    const Uniform_grid<T>& grid_h_2,
                     const T *derivative_analytics, 
                     const T *derivative_in_h, 
                     const T *derivative_in_h_2, 
                     const T *updated_runge, 
                     const std::size_t count_h_points, 
                     const std::size_t count_h_2_points, 
-                    const std::size_t count_x_points
+                    const std::size_t count_x_points,
+                    const bool binary,
+                    const std::string& filename
                     ) {
 	if (derivative_analytics == nullptr || derivative_in_h == nullptr || derivative_in_h_2 == nullptr || updated_runge == nullptr) 
 		throw std::invalid_argument("Input derivatives cannot be null");
-    if (grid_M_viz == nullptr || grid_h == nullptr || grid_h_2 == nullptr) 
-		throw std::invalid_argument("Input grids cannot be null");
 	if (count_h_points <= 0 || count_h_2_points <= 0 || count_x_points <= 0) 
 		throw std::invalid_argument("Invalid counts points");
+    if (grid_M_viz.size() != count_x_points || grid_h.size() != count_h_points || grid_h_2.size() != count_h_2_points) 
+		throw std::invalid_argument("Grids do not match counts points");
 	
+    if (binary){ // data.bin, см. Binary_format
+        using Dtype = Binary_format::Dtype<T>;
+        auto grid_entry = [](const std::string& name, const Uniform_grid<T>& grid) {
+            return Binary_format::Entry{name, "grid", grid.size(), 2 * sizeof(double), [&grid](std::ofstream& out) {
+                double ends[2] = {static_cast<double>(grid.a()), static_cast<double>(grid.b())};
+                out.write(reinterpret_cast<const char*>(ends), sizeof(ends));
+            }};
+        };
+        auto array_entry = [](const std::string& name, const T* array, std::size_t length) {
+            return Binary_format::Entry{name, Dtype::name, length, length * sizeof(typename Dtype::stored), [array, length](std::ofstream& out) {
+                write_to_file_binary(out, array, length);
+            }};
+        };
+        write_binary_file(filename.empty() ? "data.bin" : filename, {
+            grid_entry("grid_M_viz", grid_M_viz),
+            grid_entry("grid_h", grid_h),
+            grid_entry("grid_h_2", grid_h_2),
+            array_entry("derivative_analytics", derivative_analytics, count_x_points),
+            array_entry("derivative_in_h", derivative_in_h, count_h_points),
+            array_entry("derivative_in_h_2", derivative_in_h_2, count_h_2_points),
+            array_entry("updated_runge", updated_runge, count_h_points),
+        });
+        return;
+    }
 	std::ofstream out;
-    out.open("data.json"); 
+    out.open(filename.empty() ? "data.json" : filename); 
 	if (!out.is_open()) throw std::runtime_error("Cant open file");
 	else
     {
 		out << '{' << '\n';
-		write_to_file_arr(out, grid_M_viz, count_x_points, "grid_M_viz");
+		write_to_file_arr(out, grid_M_viz, "grid_M_viz");
 		out << ',' << '\n';
-		write_to_file_arr(out, grid_h, count_h_points, "grid_h");
+		write_to_file_arr(out, grid_h, "grid_h");
 		out << ',' << '\n';
-		write_to_file_arr(out, grid_h_2, count_h_2_points, "grid_h_2");
+		write_to_file_arr(out, grid_h_2, "grid_h_2");
 		out << ',' << '\n';
 		write_to_file_arr(out, derivative_analytics, count_x_points, "derivative_analytics");
 		out << ',' << '\n';
@@ -255,32 +902,12 @@ std::pair<T*,T*> calculate_norms(const T* analytical, const T* numerical, const
     if (count_nodes <= 0) 
         throw std::invalid_argument("Invalid count_nodes value.");
 
-    T* norms_abs = new T[Norms::Count]{};
-    T* norms_rel = new T[Norms::Count]{};
-    T sum_abs = 0.0, sum_2_abs = 0.0, max_abs = 0.0;
-    T sum_rel = 0.0, sum_2_rel = 0.0, max_rel = 0.0;
-    for (std::size_t i = 0; i < count_nodes; i++) {
-        T abs_error = std::abs(analytical[i] - numerical[i]);
-        sum_abs += abs_error;
-        sum_2_abs += abs_error * abs_error;
-        max_abs = std::max(max_abs, abs_error);
-        if (std::abs(analytical[i]) > std::numeric_limits<T>::epsilon()){
-            T rel_error = abs_error / std::abs(analytical[i]);
-            sum_rel += rel_error;
-            sum_2_rel += rel_error * rel_error;
-            max_rel = std::max(max_rel, rel_error);
-        }
-    }
-
-    norms_abs[Norms::L_1] = sum_abs;
-    norms_abs[Norms::L_2] = std::sqrt(sum_2_abs); 
-    norms_abs[Norms::L_inf] = max_abs;
+    auto [acc] = parallel_reduce_norms<T>(count_nodes, [&](auto& accs, std::size_t begin, std::size_t end){
+        for (std::size_t i = begin; i < end; i++)
+            accs[0].add(analytical[i], numerical[i]);
+    });
 
-    norms_rel[Norms::L_1] = sum_rel; 
-    norms_rel[Norms::L_2] = std::sqrt(sum_2_rel); 
-    norms_rel[Norms::L_inf] = max_rel;
-    
-    return std::make_pair(norms_abs, norms_rel);
+    return std::make_pair(acc.norms_abs(), acc.norms_rel());
 }
 /**
  * @brief Функция для вычисления норм одного вектора.
@@ -295,19 +922,996 @@ T* calculate_norms(const T* numerical, const std::size_t count_nodes){
     if (numerical == nullptr) throw std::invalid_argument("Input arrays cannot be null.");
     if (count_nodes <= 0) throw std::invalid_argument("Invalid count_nodes value.");
     
-    T* norms_abs = new T[Norms::Count]{};
-    T sum_abs = 0.0, sum_2_abs = 0.0, max_abs = 0.0;
-    for (std::size_t i = 0; i < count_nodes; i++) {
-        T abs_error = std::abs(numerical[i]);
-        sum_abs += abs_error;
-        sum_2_abs += abs_error * abs_error;
-        max_abs = std::max(max_abs, abs_error);
+    auto [acc] = parallel_reduce_norms<T>(count_nodes, [&](auto& accs, std::size_t begin, std::size_t end){
+        for (std::size_t i = begin; i < end; i++)
+            accs[0].add(numerical[i]);
+    });
+
+    return acc.norms_abs();
+}
+/**
+ * @brief Первая производная в узле i по шаблону Stencil<T, 1, Accuracy> на узлах, отстоящих на d индексов
+ * @tparam Accuracy Порядок точности шаблона
+ * @tparam T Тип данных (float, double, long double).
+ * @param f Массив или представление функции
+ * @param i Индекс узла (кратен d)
+ * @param last Индекс последнего узла (кратен d)
+ * @param d Шаг по индексу (1 - узлы текущей сетки, ratio - узлы более редкой сетки)
+ * @param inv_step 1 / шаг сетки, соответствующий d
+ * @note Порядок суммирования тот же, что в gen_derivative_func и stencil_interior, поэтому результаты совпадают
+ */
+template <std::size_t Accuracy, typename T, typename View>
+inline T stencil_derivative(const View& f, const std::size_t i, const std::size_t last, const std::size_t d, const T inv_step){
+    using St = Stencil<T, 1, Accuracy>;
+    const std::size_t node = i / d, last_node = last / d;
+    T sum = 0;
+    if (node < St::half_width){ // Односторонняя формула для левых узлов
+        for (std::size_t k = 0; k < St::one_sided_size; k++)
+            sum += St::left[node][k] * f[k * d];
+        return sum * inv_step;
     }
-    norms_abs[Norms::L_1] = sum_abs;
-    norms_abs[Norms::L_2] = std::sqrt(sum_2_abs); 
-    norms_abs[Norms::L_inf] = max_abs;
-    
-    return norms_abs;
+    if (node + St::half_width > last_node){ // Зеркальная односторонняя формула для правых узлов
+        for (std::size_t k = 0; k < St::one_sided_size; k++)
+            sum += St::left[last_node - node][k] * f[last - k * d];
+        return St::right_sign * sum * inv_step;
+    }
+    for (std::size_t k = 0; k < St::central_size; k++)
+        sum += St::central[k] * f[i - St::half_width * d + k * d];
+    return sum * inv_step;
+}
+/// Знаменатель главного члена погрешности Рунге-Ромберга при измельчении шага в 2 раза: 2^Accuracy - 1
+template <typename T, std::size_t Accuracy>
+inline constexpr T runge_divisor = static_cast<T>((std::size_t(1) << Accuracy) - 1);
+/**
+ * @brief Функция для вычисления производных на сетках h и h/2, уточнения по Рунге-Ромбергу и норм ошибок за один проход
+ * @tparam Accuracy Порядок точности шаблона Stencil (По умолчанию 2)
+ * @tparam T Тип данных (float, double, long double).
+ * @param func_in_h_2 Массив функции на сетке h/2 (значения на сетке h - его четные элементы)
+ * @param derivative_analytics_in_h_2 Массив аналитической производной на сетке h/2
+ * @param count_nodes_h_2 Количество узлов сетки h/2 (По умолчанию Task_const::M_2)
+ * @param step_h_2 Шаг сетки h/2 (По умолчанию Task_const::STEP_H_2)
+ * @param store Битовая маска Store::Type массивов, которые нужно сохранить (По умолчанию Store::All)
+ * @return Структура Pipeline_result, несохраненные массивы равны nullptr
+ * @note Массивы на сетке h имеют размер (count_nodes_h_2 + 1) / 2, на сетке h/2 - count_nodes_h_2.
+ *       Нормы Рунге считаются относительно аналитической производной в узлах сетки h.
+ */
+template <std::size_t Accuracy, typename T>
+Pipeline_result<T> gen_fused_pipeline(
+                const T* func_in_h_2,
+                const T* derivative_analytics_in_h_2,
+                const std::size_t count_nodes_h_2,
+                const T step_h_2,
+                const unsigned store
+                ){
+    return gen_fused_pipeline<Accuracy>(Strided_view<const T>{func_in_h_2, count_nodes_h_2, 1},
+                                        Strided_view<const T>{derivative_analytics_in_h_2, count_nodes_h_2, 1},
+                                        step_h_2, store);
+}
+/**
+ * @brief Версия gen_fused_pipeline для представлений, например сетки h/2 внутри буфера более мелкой сетки
+ * @tparam Accuracy Порядок точности шаблона Stencil (По умолчанию 2)
+ * @tparam T Тип данных (float, double, long double).
+ * @param func_in_h_2 Представление функции на сетке h/2
+ * @param derivative_analytics_in_h_2 Представление аналитической производной на сетке h/2
+ * @param step_h_2 Шаг сетки h/2
+ * @param store Битовая маска Store::Type массивов, которые нужно сохранить (По умолчанию Store::All)
+ * @return Структура Pipeline_result, выходные массивы непрерывные
+ */
+template <std::size_t Accuracy, typename T>
+Pipeline_result<T> gen_fused_pipeline(
+                const Strided_view<const T>& func_in_h_2,
+                const Strided_view<const T>& derivative_analytics_in_h_2,
+                const T step_h_2,
+                const unsigned store
+                ){
+    using St = Stencil<T, 1, Accuracy>;
+    const std::size_t count_nodes_h_2 = func_in_h_2.size();
+    if (func_in_h_2.data == nullptr || derivative_analytics_in_h_2.data == nullptr)
+        throw std::invalid_argument("Input arrays cannot be null.");
+    if (derivative_analytics_in_h_2.size() != count_nodes_h_2)
+        throw std::invalid_argument("Invalid count_nodes");
+    if (count_nodes_h_2 % 2 == 0 || (count_nodes_h_2 + 1) / 2 < St::min_count_nodes) // Шаблон должен помещаться на сетке h
+        throw std::invalid_argument("Invalid count_nodes");
+    if (step_h_2 <= 0) throw std::invalid_argument("Invalid step");
+
+    const std::size_t ratio = 2;
+    const std::size_t count_nodes_h = (count_nodes_h_2 + 1) / ratio;
+    const std::size_t last = count_nodes_h_2 - 1;
+    const auto& f = func_in_h_2;
+
+    Pipeline_result<T> result;
+    result.count_nodes_h = count_nodes_h;
+    result.count_nodes_h_2 = count_nodes_h_2;
+    if (store & Store::Derivative_h) result.derivative_in_h = new T[count_nodes_h]{};
+    if (store & Store::Derivative_h_2) result.derivative_in_h_2 = new T[count_nodes_h_2]{};
+    if (store & Store::Runge) result.updated_runge = new T[count_nodes_h]{};
+    if (store & Store::Leading_error) result.leading_error = new T[count_nodes_h]{};
+
+    const T inv_step_h_2 = 1 / step_h_2; // Обратные шаги, чтобы не делить в каждом узле
+    const T inv_step_h = 1 / (step_h_2 * ratio);
+    // Parallel::chunk_size четный, поэтому каждый блок начинается с узла сетки h
+    auto accs = parallel_reduce_norms<T, 4>(count_nodes_h_2, [&](auto& acc, std::size_t begin, std::size_t end){
+        auto& [acc_h, acc_h_2, acc_runge, acc_leading] = acc;
+        for (std::size_t i = begin; i < end; i++){
+            T der_h_2 = stencil_derivative<Accuracy>(f, i, last, 1, inv_step_h_2);
+            acc_h_2.add(derivative_analytics_in_h_2[i], der_h_2);
+            if (result.derivative_in_h_2 != nullptr) result.derivative_in_h_2[i] = der_h_2;
+
+            if (i % ratio != 0) continue; // Дальше только узлы сетки h
+            std::size_t j = i / ratio; // j - индекс по крупной сетке, i по мелкой
+            T der_h = stencil_derivative<Accuracy>(f, i, last, ratio, inv_step_h);
+            T leading_err = (der_h_2 - der_h) / runge_divisor<T, Accuracy>;
+            T runge = der_h_2 + leading_err;
+
+            acc_h.add(derivative_analytics_in_h_2[i], der_h);
+            acc_runge.add(derivative_analytics_in_h_2[i], runge);
+            acc_leading.add(leading_err);
+            if (result.derivative_in_h != nullptr) result.derivative_in_h[j] = der_h;
+            if (result.updated_runge != nullptr) result.updated_runge[j] = runge;
+            if (result.leading_error != nullptr) result.leading_error[j] = leading_err;
+        }
+    });
+    auto& [acc_h, acc_h_2, acc_runge, acc_leading] = accs;
+
+    result.errors_in_h = std::make_pair(acc_h.norms_abs(), acc_h.norms_rel());
+    result.errors_in_h_2 = std::make_pair(acc_h_2.norms_abs(), acc_h_2.norms_rel());
+    result.errors_runge = std::make_pair(acc_runge.norms_abs(), acc_runge.norms_rel());
+    result.norms_leading_error = acc_leading.norms_abs();
+    return result;
+}
+/**
+ * @brief Функция для вычисления заданных функций для набора сигналов на общей сетке
+ * @tparam T Тип данных (float, double, long double).
+ * @param grid Равномерная сетка, общая для всех сигналов
+ * @param count_signals Количество сигналов
+ * @param func Функция func(signal, x) -> T, значение сигнала signal в точке x
+ * @param layout Расположение данных (По умолчанию Layout::SoA)
+ * @return Массив размера count_signals * grid.size() в расположении layout
+ * @note Координата узла вычисляется один раз для блока сигналов. Блоки сигналов и узлов распределяются по потокам (parallel_for_batch).
+ * @warning func вызывается одновременно из нескольких потоков и должна быть потокобезопасной.
+ *          Для последовательных вызовов задайте Parallel::thread_count = 1.
+ */
+template <typename T, typename Func>
+T* gen_batch_func(const Uniform_grid<T>& grid, const std::size_t count_signals, Func&& func, const Layout::Type layout){
+    if (count_signals < 1) throw std::invalid_argument("Invalid count_signals");
+    const std::size_t count_nodes = grid.size();
+    T* batch = new T[count_signals * count_nodes]{};
+    try {
+        parallel_for_batch(count_signals, count_nodes, [&](std::size_t, std::size_t s_begin, std::size_t s_end, std::size_t begin, std::size_t end){
+            for (std::size_t i = begin; i < end; i++){
+                const T x = grid[i];
+                for (std::size_t s = s_begin; s < s_end; s++)
+                    batch[layout == Layout::SoA ? s * count_nodes + i : i * count_signals + s] = func(s, x);
+            }
+        });
+    }
+    catch (...) {
+        delete[] batch;
+        throw;
+    }
+    return batch;
+}
+/**
+ * @brief Пакетная версия gen_fused_pipeline: производные на сетках h и h/2, уточнение по Рунге-Ромбергу и нормы для каждого сигнала
+ * @tparam Accuracy Порядок точности шаблона Stencil (По умолчанию 2)
+ * @tparam T Тип данных (float, double, long double).
+ * @param func_in_h_2 Массив значений сигналов на сетке h/2, размер count_signals * count_nodes_h_2
+ * @param derivative_analytics_in_h_2 Массив аналитических производных в том же расположении или nullptr (тогда нормы ошибок не считаются)
+ * @param count_signals Количество сигналов
+ * @param count_nodes_h_2 Количество узлов сетки h/2
+ * @param step_h_2 Шаг сетки h/2
+ * @param layout Расположение входных и выходных массивов (По умолчанию Layout::SoA)
+ * @param store Битовая маска Store::Type массивов, которые нужно сохранить (По умолчанию Store::All)
+ * @return Структура Batch_result
+ * @note Краевые узлы считаются отдельно, поэтому внутренние циклы не содержат ветвлений и векторизуются:
+ *       при Layout::AoS - по сигналам строки узла, при Layout::SoA - по узлам сигнала (сетка h/2 - ядром stencil_interior).
+ *       Блоки сигналов и узлов распределяются по потокам (parallel_for_batch). Нормы накапливаются по тем же блокам узлов
+ *       и в том же порядке, что и в gen_fused_pipeline, и не зависят от количества потоков.
+ */
+template <std::size_t Accuracy, typename T>
+Batch_result<T> gen_batch_pipeline(
+                const T* func_in_h_2,
+                const T* derivative_analytics_in_h_2,
+                const std::size_t count_signals,
+                const std::size_t count_nodes_h_2,
+                const T step_h_2,
+                const Layout::Type layout,
+                const unsigned store
+                ){
+    using St = Stencil<T, 1, Accuracy>;
+    if (func_in_h_2 == nullptr) throw std::invalid_argument("Input arrays cannot be null.");
+    if (count_signals < 1) throw std::invalid_argument("Invalid count_signals");
+    if (count_nodes_h_2 % 2 == 0 || (count_nodes_h_2 + 1) / 2 < St::min_count_nodes) // Шаблон должен помещаться на сетке h
+        throw std::invalid_argument("Invalid count_nodes");
+    if (step_h_2 <= 0) throw std::invalid_argument("Invalid step");
+
+    const std::size_t ratio = 2;
+    const std::size_t count_nodes_h = (count_nodes_h_2 + 1) / ratio;
+    const std::size_t last = count_nodes_h_2 - 1;
+    const T inv_step_h_2 = 1 / step_h_2; // Обратные шаги, чтобы не делить в каждом узле
+    const T inv_step_h = 1 / (step_h_2 * ratio);
+    const bool has_analytics = derivative_analytics_in_h_2 != nullptr;
+
+    Batch_result<T> result;
+    result.count_signals = count_signals;
+    result.count_nodes_h = count_nodes_h;
+    result.count_nodes_h_2 = count_nodes_h_2;
+    result.layout = layout;
+    if (store & Store::Derivative_h) result.derivative_in_h = new T[count_signals * count_nodes_h]{};
+    if (store & Store::Derivative_h_2) result.derivative_in_h_2 = new T[count_signals * count_nodes_h_2]{};
+    if (store & Store::Runge) result.updated_runge = new T[count_signals * count_nodes_h]{};
+    if (store & Store::Leading_error) result.leading_error = new T[count_signals * count_nodes_h]{};
+
+    using Accs = std::array<Norm_accumulator<T>, 4>; // h, h/2, Рунге, главный член погрешности
+    constexpr std::size_t block = Parallel::batch_block;
+    constexpr std::size_t hw = St::half_width;
+    constexpr std::size_t cs = St::central_size;
+    constexpr auto central = St::central;
+    const T leading_divisor = runge_divisor<T, Accuracy>;
+    const std::size_t count_chunks = (count_nodes_h_2 + Parallel::chunk_size - 1) / Parallel::chunk_size;
+    std::vector<Accs> partial(count_chunks * count_signals); // Частичные нормы по блокам узлов для каждого сигнала
+
+    // Сигнал за сигналом: узлы обрабатываются тайлами по block, производные тайла вычисляются векторно в локальные массивы,
+    // нормы одного сигнала накапливаются последовательно по узлам, как в gen_fused_pipeline
+    auto body_soa = [&](std::size_t chunk, std::size_t s_begin, std::size_t s_end, std::size_t begin, std::size_t end){
+        for (std::size_t s = s_begin; s < s_end; s++){
+            const T* f = func_in_h_2 + s * count_nodes_h_2;
+            const T* analytics = has_analytics ? derivative_analytics_in_h_2 + s * count_nodes_h_2 : nullptr;
+            auto& [acc_h, acc_h_2, acc_runge, acc_leading] = partial[chunk * count_signals + s];
+            for (std::size_t t_begin = begin; t_begin < end; t_begin += block){ // t_begin четный, тайл начинается с узла сетки h
+                const std::size_t t_end = std::min(t_begin + block, end);
+                const std::size_t count_tile = t_end - t_begin;
+                const std::size_t j_begin = t_begin / ratio, j_end = (t_end + 1) / ratio;
+                const std::size_t count_tile_h = j_end - j_begin;
+                T der_h_2[block], der_h[block / 2], leading_err[block / 2], runge[block / 2];
+
+                // Сетка h/2: внутренние узлы [lo, hi) - ядром stencil_interior, краевые - stencil_derivative
+                const std::size_t lo = std::clamp(hw, t_begin, t_end), hi = std::clamp(count_nodes_h_2 - hw, t_begin, t_end);
+                for (std::size_t i = t_begin; i < lo; i++)
+                    der_h_2[i - t_begin] = stencil_derivative<Accuracy>(f, i, last, 1, inv_step_h_2);
+                if (lo < hi) stencil_interior<cs>(central.data(), f + lo - hw, der_h_2 + (lo - t_begin), hi - lo, inv_step_h_2);
+                for (std::size_t i = hi; i < t_end; i++)
+                    der_h_2[i - t_begin] = stencil_derivative<Accuracy>(f, i, last, 1, inv_step_h_2);
+
+                // Сетка h: каждый ratio-й узел сигнала
+                const std::size_t lo_h = std::clamp(hw, j_begin, j_end), hi_h = std::clamp(count_nodes_h - hw, j_begin, j_end);
+                for (std::size_t j = j_begin; j < lo_h; j++)
+                    der_h[j - j_begin] = stencil_derivative<Accuracy>(f, ratio * j, last, ratio, inv_step_h);
+                for (std::size_t j = lo_h; j < hi_h; j++){
+                    const T* f_j = f + ratio * (j - hw);
+                    T sum = 0;
+                    for (std::size_t m = 0; m < cs; m++)
+                        sum += central[m] * f_j[ratio * m];
+                    der_h[j - j_begin] = sum * inv_step_h;
+                }
+                for (std::size_t j = hi_h; j < j_end; j++)
+                    der_h[j - j_begin] = stencil_derivative<Accuracy>(f, ratio * j, last, ratio, inv_step_h);
+                for (std::size_t k = 0; k < count_tile_h; k++){
+                    leading_err[k] = (der_h_2[ratio * k] - der_h[k]) / leading_divisor;
+                    runge[k] = der_h_2[ratio * k] + leading_err[k];
+                }
+
+                if (result.derivative_in_h_2 != nullptr)
+                    std::copy(der_h_2, der_h_2 + count_tile, result.derivative_in_h_2 + s * count_nodes_h_2 + t_begin);
+                if (result.derivative_in_h != nullptr)
+                    std::copy(der_h, der_h + count_tile_h, result.derivative_in_h + s * count_nodes_h + j_begin);
+                if (result.updated_runge != nullptr)
+                    std::copy(runge, runge + count_tile_h, result.updated_runge + s * count_nodes_h + j_begin);
+                if (result.leading_error != nullptr)
+                    std::copy(leading_err, leading_err + count_tile_h, result.leading_error + s * count_nodes_h + j_begin);
+
+                if (has_analytics){
+                    for (std::size_t k = 0; k < count_tile; k++)
+                        acc_h_2.add(analytics[t_begin + k], der_h_2[k]);
+                    for (std::size_t k = 0; k < count_tile_h; k++){
+                        acc_h.add(analytics[t_begin + ratio * k], der_h[k]);
+                        acc_runge.add(analytics[t_begin + ratio * k], runge[k]);
+                    }
+                }
+                for (std::size_t k = 0; k < count_tile_h; k++)
+                    acc_leading.add(leading_err[k]);
+            }
+        }
+    };
+    // Узел за узлом: строка узла i непрерывна в памяти, центральный шаблон - сумма строк i - hw*d, ..., i + hw*d,
+    // внутренние циклы по сигналам блока без ветвлений, нормы каждого сигнала - в массивах Norm_block_accumulator
+    auto body_aos = [&](std::size_t chunk, std::size_t s_begin, std::size_t s_end, std::size_t begin, std::size_t end){
+        const std::size_t count_block = s_end - s_begin;
+        Norm_block_accumulator<T> block_h, block_h_2, block_runge, block_leading;
+        auto column = [&](std::size_t k) { // Сигнал s_begin + k как представление массива
+            return Strided_view<const T>{func_in_h_2 + s_begin + k, count_nodes_h_2, count_signals};
+        };
+        auto derivative_row = [&](T* out, std::size_t i, std::size_t d, T inv_step){
+            if (i / d < hw || i / d + hw > last / d){ // Краевой узел сетки с шагом d
+                for (std::size_t k = 0; k < count_block; k++)
+                    out[k] = stencil_derivative<Accuracy>(column(k), i, last, d, inv_step);
+                return;
+            }
+            std::fill(out, out + count_block, T(0));
+            for (std::size_t m = 0; m < cs; m++){
+                const T* row = func_in_h_2 + (i - hw * d + m * d) * count_signals + s_begin;
+                for (std::size_t k = 0; k < count_block; k++)
+                    out[k] += central[m] * row[k];
+            }
+            for (std::size_t k = 0; k < count_block; k++)
+                out[k] *= inv_step;
+        };
+        for (std::size_t i = begin; i < end; i++){
+            const bool node_h = i % ratio == 0;
+            T der_h_2[block], der_h[block], leading_err[block], runge[block];
+
+            derivative_row(der_h_2, i, 1, inv_step_h_2);
+            if (node_h){
+                derivative_row(der_h, i, ratio, inv_step_h);
+                for (std::size_t k = 0; k < count_block; k++){
+                    leading_err[k] = (der_h_2[k] - der_h[k]) / leading_divisor;
+                    runge[k] = der_h_2[k] + leading_err[k];
+                }
+            }
+
+            const std::size_t offset_h_2 = i * count_signals + s_begin;
+            const std::size_t offset_h = i / ratio * count_signals + s_begin;
+            if (result.derivative_in_h_2 != nullptr)
+                std::copy(der_h_2, der_h_2 + count_block, result.derivative_in_h_2 + offset_h_2);
+            if (has_analytics) block_h_2.add(derivative_analytics_in_h_2 + offset_h_2, der_h_2, count_block);
+            if (!node_h) continue; // Дальше только узлы сетки h
+            if (result.derivative_in_h != nullptr)
+                std::copy(der_h, der_h + count_block, result.derivative_in_h + offset_h);
+            if (result.updated_runge != nullptr)
+                std::copy(runge, runge + count_block, result.updated_runge + offset_h);
+            if (result.leading_error != nullptr)
+                std::copy(leading_err, leading_err + count_block, result.leading_error + offset_h);
+            if (has_analytics){
+                block_h.add(derivative_analytics_in_h_2 + offset_h_2, der_h, count_block);
+                block_runge.add(derivative_analytics_in_h_2 + offset_h_2, runge, count_block);
+            }
+            block_leading.add(leading_err, count_block);
+        }
+        for (std::size_t k = 0; k < count_block; k++)
+            partial[chunk * count_signals + s_begin + k] = {block_h.get(k), block_h_2.get(k), block_runge.get(k), block_leading.get(k)};
+    };
+    // Parallel::chunk_size четный, поэтому каждый блок начинается с узла сетки h
+    if (layout == Layout::SoA) parallel_for_batch(count_signals, count_nodes_h_2, body_soa);
+    else parallel_for_batch(count_signals, count_nodes_h_2, body_aos);
+
+    if (has_analytics){
+        result.errors_in_h = std::make_pair(new T[count_signals * Norms::Count]{}, new T[count_signals * Norms::Count]{});
+        result.errors_in_h_2 = std::make_pair(new T[count_signals * Norms::Count]{}, new T[count_signals * Norms::Count]{});
+        result.errors_runge = std::make_pair(new T[count_signals * Norms::Count]{}, new T[count_signals * Norms::Count]{});
+    }
+    result.norms_leading_error = new T[count_signals * Norms::Count]{};
+    static auto copy_norms = [](T* norms, T* out) { // Перенос нормы одного сигнала в общий массив
+        std::copy(norms, norms + Norms::Count, out);
+        delete[] norms;
+    };
+    for (std::size_t s = 0; s < count_signals; s++){
+        Accs total{};
+        for (std::size_t chunk = 0; chunk < count_chunks; chunk++)
+            for (std::size_t k = 0; k < total.size(); k++)
+                total[k].merge(partial[chunk * count_signals + s][k]);
+        auto& [acc_h, acc_h_2, acc_runge, acc_leading] = total;
+        const std::size_t offset = s * Norms::Count;
+        if (has_analytics){
+            copy_norms(acc_h.norms_abs(), result.errors_in_h.first + offset);
+            copy_norms(acc_h.norms_rel(), result.errors_in_h.second + offset);
+            copy_norms(acc_h_2.norms_abs(), result.errors_in_h_2.first + offset);
+            copy_norms(acc_h_2.norms_rel(), result.errors_in_h_2.second + offset);
+            copy_norms(acc_runge.norms_abs(), result.errors_runge.first + offset);
+            copy_norms(acc_runge.norms_rel(), result.errors_runge.second + offset);
+        }
+        copy_norms(acc_leading.norms_abs(), result.norms_leading_error + offset);
+    }
+    return result;
+}
+/**
+ * @brief Адаптивное уточнение производной в узлах сетки по Ромбергу: таблица Ричардсона строится по уровням h/2^k
+ * @tparam T Тип данных (float, double, long double).
+ * @param grid Равномерная сетка, в узлах которой вычисляется производная
+ * @param func Функция func(x) -> T
+ * @param tolerance Допустимая величина главного члена погрешности
+ * @param max_levels Максимальное количество измельчений шага (По умолчанию 10)
+ * @param interval_nodes Количество узлов в подынтервале, измельчение прекращается сразу для всего подынтервала,
+ *        когда максимум главного члена погрешности в нем меньше tolerance (По умолчанию 0 - один подынтервал на всю сетку)
+ * @return Структура Romberg_result
+ * @note На уровне 0 функция вычисляется во всех узлах сетки, на уровне k - только в точках x_j +- h/2^k активных узлов.
+ *       Середины отрезков уровня 1 общие для соседних узлов, краевые формулы берут f(x_0 + 2h/2^k) с предыдущего уровня.
+ *       Во внутренних узлах погрешность раскладывается по четным степеням h, на краях (односторонняя формула) - по всем степеням, начиная с h^2.
+ * @warning func вызывается одновременно из нескольких потоков и должна быть потокобезопасной.
+ *          Для последовательных вызовов задайте Parallel::thread_count = 1.
+ */
+template <typename T, typename Func>
+Romberg_result<T> gen_adaptive_romberg(
+                const Uniform_grid<T>& grid,
+                Func&& func,
+                const T tolerance,
+                const std::size_t max_levels,
+                const std::size_t interval_nodes
+                ){
+    const std::size_t count_nodes = grid.size();
+    if (count_nodes < 3) throw std::invalid_argument("Invalid count_nodes");
+    if (tolerance <= 0) throw std::invalid_argument("Invalid tolerance");
+    if (max_levels < 1 || max_levels > 60) throw std::invalid_argument("Invalid max_levels");
+
+    const std::size_t last = count_nodes - 1;
+    const std::size_t width = max_levels + 1; // Длина строки таблицы
+    const std::size_t interval = interval_nodes == 0 ? count_nodes : interval_nodes;
+    const std::size_t count_intervals = (count_nodes + interval - 1) / interval;
+    static auto denominator = [](std::size_t node, std::size_t last, std::size_t m) { // 2^p - 1, p - степень h, исключаемая на шаге m
+        std::size_t power = (node == 0 || node == last) ? m + 1 : 2 * m;
+        return std::ldexp(T(1), static_cast<int>(power)) - 1;
+    };
+
+    Romberg_result<T> result;
+    result.count_nodes = count_nodes;
+    result.derivative = new T[count_nodes]{};
+    result.leading_error = new T[count_nodes]{};
+    result.levels = new std::size_t[count_nodes]{};
+
+    std::vector<T> rows(count_nodes * width); // Последняя строка таблицы для каждого узла
+    std::vector<T> samples(count_nodes); // f(x_j)
+    std::vector<T> left(count_nodes), right(count_nodes); // f(x_j - h_k), f(x_j + h_k) на текущем уровне
+    std::vector<T> right_prev(count_nodes), left_prev(count_nodes); // То же на предыдущем уровне (для краевых формул)
+    std::vector<char> active_interval(count_intervals, 1);
+    std::atomic<std::size_t> count_evaluations{0};
+    auto is_active = [&](std::size_t j) { return active_interval[j / interval] != 0; };
+
+    // Уровень 0: значения во всех узлах сетки
+    parallel_for_chunks(count_nodes, [&](std::size_t, std::size_t begin, std::size_t end){
+        for (std::size_t j = begin; j < end; j++)
+            samples[j] = func(grid[j]);
+    });
+    count_evaluations += count_nodes;
+    for (std::size_t j = 0; j < count_nodes; j++){
+        left[j] = j > 0 ? samples[j - 1] : T(0);
+        right[j] = j < last ? samples[j + 1] : T(0);
+    }
+
+    T step = grid.step();
+    for (std::size_t level = 0; level <= max_levels; level++){
+        if (level > 0){ // Новые точки x_j +- h_k только для активных узлов
+            step /= 2;
+            std::swap(left, left_prev);
+            std::swap(right, right_prev);
+            parallel_for_chunks(count_nodes, [&](std::size_t, std::size_t begin, std::size_t end){
+                std::size_t evaluations = 0;
+                for (std::size_t j = begin; j < end; j++){
+                    // На уровне 1 правая точка узла j - середина [x_j, x_j+1], нужна и узлу j + 1
+                    bool need = is_active(j) || (level == 1 && j < last && is_active(j + 1));
+                    if (need && j < last){ right[j] = func(grid[j] + step); evaluations++; }
+                }
+                count_evaluations += evaluations;
+            });
+            parallel_for_chunks(count_nodes, [&](std::size_t, std::size_t begin, std::size_t end){
+                std::size_t evaluations = 0;
+                for (std::size_t j = begin; j < end; j++){
+                    if (!is_active(j) || j == 0) continue;
+                    if (level == 1) left[j] = right[j - 1];
+                    else { left[j] = func(grid[j] - step); evaluations++; }
+                }
+                count_evaluations += evaluations;
+            });
+        }
+        // Новая строка таблицы и главный член погрешности
+        parallel_for_chunks(count_nodes, [&](std::size_t, std::size_t begin, std::size_t end){
+            for (std::size_t j = begin; j < end; j++){
+                if (!is_active(j)) continue;
+                T der;
+                if (j == 0) der = (-3.0*samples[0] + 4.0*right[0] - (level == 0 ? samples[2] : right_prev[0])) / (2.0 * step);
+                else if (j == last) der = (3.0*samples[last] - 4.0*left[last] + (level == 0 ? samples[last - 2] : left_prev[last])) / (2.0 * step);
+                else der = (right[j] - left[j]) / (2 * step);
+
+                T* row = rows.data() + j * width;
+                T prev = row[0];
+                row[0] = der;
+                for (std::size_t m = 1; m <= level; m++){
+                    T old = row[m];
+                    row[m] = row[m-1] + (row[m-1] - prev) / denominator(j, last, m);
+                    prev = old;
+                }
+                result.derivative[j] = row[level];
+                result.leading_error[j] = level > 0 ? row[level] - row[level-1] : T(0);
+                result.levels[j] = level;
+            }
+        });
+        if (level == 0) continue;
+        // Остановка подынтервалов, в которых погрешность меньше tolerance
+        bool any_active = false;
+        for (std::size_t k = 0; k < count_intervals; k++){
+            if (!active_interval[k]) continue;
+            T max_error = 0;
+            for (std::size_t j = k * interval; j < std::min((k + 1) * interval, count_nodes); j++)
+                max_error = std::max(max_error, std::abs(result.leading_error[j]));
+            active_interval[k] = max_error >= tolerance;
+            any_active = any_active || active_interval[k];
+        }
+        if (!any_active) break;
+    }
+    result.count_evaluations = count_evaluations;
+    return result;
+}
+/**
+ * @brief Кольцевой буфер последних Capacity отсчетов, индексируется абсолютным номером отсчета
+ * @tparam T Тип данных (float, double, long double).
+ * @tparam Capacity Размер буфера (степень двойки)
+ */
+template <typename T, std::size_t Capacity>
+struct Ring_buffer {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    std::array<T, Capacity> data{};
+    T& operator[](const std::size_t i) { return data[i & (Capacity - 1)]; }
+    const T& operator[](const std::size_t i) const { return data[i & (Capacity - 1)]; }
+};
+/// Наименьшая степень двойки, не меньшая count (размер Ring_buffer)
+constexpr std::size_t ceil_pow2(const std::size_t count){
+    std::size_t result = 1;
+    while (result < count) result *= 2;
+    return result;
+}
+/**
+ * @brief Потоковое вычисление производной: отсчеты поступают по одному или блоками, память постоянная
+ * @tparam T Тип данных (float, double, long double).
+ * @tparam Accuracy Порядок точности шаблона Stencil (По умолчанию 2)
+ * @note Производная в узле n выдается после поступления отсчета n + half_width (задержка half_width отсчетов),
+ *       в первых half_width узлах - после отсчета one_sided_size - 1. Последние half_width узлов выдаются в finish().
+ *       Формулы те же, что в gen_derivative_func.
+ */
+template <typename T, std::size_t Accuracy = 2>
+class Stream_differentiator {
+    using St = Stencil<T, 1, Accuracy>;
+public:
+    /**
+     * @param step Шаг по времени (сетки)
+     * @param x0 Координата первого отсчета (По умолчанию Task_const::A)
+     * @param analytic Аналитическая производная для норм ошибок (По умолчанию не задана, тогда считаются нормы самой производной)
+     */
+    explicit Stream_differentiator(const T step, const T x0=Task_const::A, std::function<T(T)> analytic=nullptr)
+        : step_(step), inv_step_(1 / step), x0_(x0), analytic_(std::move(analytic)) {
+        if (step <= 0) throw std::invalid_argument("Invalid step");
+    }
+    /// Добавить отсчет, в out записывается до half_width + 1 значений, возвращает их количество
+    std::size_t push(const T sample, T* out){
+        if (finished_) throw std::logic_error("Stream is finished");
+        std::size_t count_out = 0;
+        buffer_[count_samples_] = sample;
+        count_samples_++;
+        if (count_samples_ < St::one_sided_size) return 0;
+        const std::size_t current = count_samples_ - 1;
+        if (count_samples_ == St::one_sided_size) // Односторонние формулы для первых узлов
+            for (std::size_t node = 0; node < St::half_width; node++)
+                out[count_out++] = emit(node, NO_LAST);
+        out[count_out++] = emit(current - St::half_width, NO_LAST);
+        return count_out;
+    }
+    /// Добавить блок отсчетов, out должен вмещать count + half_width значений, возвращает количество записанных
+    std::size_t push(const T* samples, const std::size_t count, T* out){
+        if (samples == nullptr || out == nullptr) throw std::invalid_argument("Input arrays cannot be null.");
+        std::size_t count_out = 0;
+        for (std::size_t i = 0; i < count; i++)
+            count_out += push(samples[i], out + count_out);
+        return count_out;
+    }
+    /// Завершить поток: в out записываются производные в последних half_width узлах (односторонние формулы)
+    std::size_t finish(T* out){
+        if (finished_) return 0;
+        if (count_samples_ < St::min_count_nodes) throw std::invalid_argument("Invalid count_nodes");
+        finished_ = true;
+        const std::size_t last = count_samples_ - 1;
+        std::size_t count_out = 0;
+        for (std::size_t node = last + 1 - St::half_width; node <= last; node++)
+            out[count_out++] = emit(node, last);
+        return count_out;
+    }
+    std::size_t count_samples() const { return count_samples_; }
+    std::size_t count_emitted() const { return count_emitted_; }
+    /// Текущие нормы (abs, rel) выданных значений, массивы размера Norms::Count
+    std::pair<T*, T*> norms() const { return std::make_pair(acc_.norms_abs(), acc_.norms_rel()); }
+
+private:
+    static constexpr std::size_t NO_LAST = std::numeric_limits<std::size_t>::max(); // Последний узел еще не известен
+    T emit(const std::size_t node, const std::size_t last){
+        T der = stencil_derivative<Accuracy>(buffer_, node, last, 1, inv_step_);
+        if (analytic_) acc_.add(analytic_(x0_ + step_ * node), der);
+        else acc_.add(der);
+        count_emitted_++;
+        return der;
+    }
+    T step_, inv_step_, x0_;
+    std::function<T(T)> analytic_;
+    Ring_buffer<T, ceil_pow2(St::one_sided_size)> buffer_; // Вмещает шаблон одного узла
+    Norm_accumulator<T> acc_;
+    std::size_t count_samples_ = 0;
+    std::size_t count_emitted_ = 0;
+    bool finished_ = false;
+};
+/**
+ * @brief Потоковое вычисление производной с уточнением по Рунге-Ромбергу: отсчеты идут с шагом h/2, результат - в каждом втором узле (сетка h)
+ * @tparam T Тип данных (float, double, long double).
+ * @tparam Accuracy Порядок точности шаблона Stencil (По умолчанию 2)
+ * @note Узел сетки h с номером отсчета i выдается после поступления отсчета i + 2 * half_width, первые half_width узлов -
+ *       после отсчета 2 * (one_sided_size - 1). Последние half_width узлов выдаются в finish(), общее количество отсчетов
+ *       должно быть нечетным. Результаты совпадают с gen_fused_pipeline.
+ */
+template <typename T, std::size_t Accuracy = 2>
+class Stream_runge_differentiator {
+    using St = Stencil<T, 1, Accuracy>;
+public:
+    /**
+     * @param step_h_2 Шаг поступления отсчетов h/2
+     * @param x0 Координата первого отсчета (По умолчанию Task_const::A)
+     * @param analytic Аналитическая производная для норм ошибок (По умолчанию не задана, тогда считаются нормы самой производной)
+     */
+    explicit Stream_runge_differentiator(const T step_h_2, const T x0=Task_const::A, std::function<T(T)> analytic=nullptr)
+        : step_h_2_(step_h_2), inv_step_h_2_(1 / step_h_2), inv_step_h_(1 / (step_h_2 * ratio)), x0_(x0), analytic_(std::move(analytic)) {
+        if (step_h_2 <= 0) throw std::invalid_argument("Invalid step");
+    }
+    /// Добавить отсчет, в out_runge (и out_leading_error, если не nullptr) записывается до half_width + 1 значений, возвращает их количество
+    std::size_t push(const T sample, T* out_runge, T* out_leading_error=nullptr){
+        if (finished_) throw std::logic_error("Stream is finished");
+        buffer_[count_samples_] = sample;
+        count_samples_++;
+        const std::size_t current = count_samples_ - 1;
+        const std::size_t first = ratio * (St::one_sided_size - 1); // После этого отсчета известны первые узлы сетки h
+        if (current < first || current % ratio != 0) return 0;
+        std::size_t count_out = 0;
+        if (current == first)
+            for (std::size_t j = 0; j < St::half_width; j++)
+                emit(ratio * j, NO_LAST, out_runge, out_leading_error, count_out);
+        emit(current - ratio * St::half_width, NO_LAST, out_runge, out_leading_error, count_out);
+        return count_out;
+    }
+    /// Добавить блок отсчетов, выходные массивы должны вмещать count / 2 + half_width + 1 значений, возвращает количество записанных
+    std::size_t push(const T* samples, const std::size_t count, T* out_runge, T* out_leading_error=nullptr){
+        if (samples == nullptr || out_runge == nullptr) throw std::invalid_argument("Input arrays cannot be null.");
+        std::size_t count_out = 0;
+        for (std::size_t i = 0; i < count; i++)
+            count_out += push(samples[i], out_runge + count_out, out_leading_error ? out_leading_error + count_out : nullptr);
+        return count_out;
+    }
+    /// Завершить поток: выдаются последние half_width узлов сетки h (односторонние формулы)
+    std::size_t finish(T* out_runge, T* out_leading_error=nullptr){
+        if (finished_) return 0;
+        if (count_samples_ % 2 == 0 || (count_samples_ + 1) / ratio < St::min_count_nodes) throw std::invalid_argument("Invalid count_nodes");
+        finished_ = true;
+        const std::size_t last = count_samples_ - 1;
+        std::size_t count_out = 0;
+        for (std::size_t j = last / ratio + 1 - St::half_width; j <= last / ratio; j++)
+            emit(ratio * j, last, out_runge, out_leading_error, count_out);
+        return count_out;
+    }
+    std::size_t count_samples() const { return count_samples_; }
+    std::size_t count_emitted() const { return count_emitted_; }
+    /// Текущие нормы (abs, rel) уточненной производной, массивы размера Norms::Count
+    std::pair<T*, T*> norms_runge() const { return std::make_pair(acc_runge_.norms_abs(), acc_runge_.norms_rel()); }
+    /// Текущие нормы главного члена погрешности, массив размера Norms::Count
+    T* norms_leading_error() const { return acc_leading_.norms_abs(); }
+
+private:
+    static constexpr std::size_t ratio = 2;
+    static constexpr std::size_t NO_LAST = std::numeric_limits<std::size_t>::max(); // Последний узел еще не известен
+    void emit(const std::size_t node, const std::size_t last, T* out_runge, T* out_leading_error, std::size_t& count_out){
+        T der_h_2 = stencil_derivative<Accuracy>(buffer_, node, last, 1, inv_step_h_2_);
+        T der_h = stencil_derivative<Accuracy>(buffer_, node, last, ratio, inv_step_h_);
+        T leading_err = (der_h_2 - der_h) / runge_divisor<T, Accuracy>;
+        T runge = der_h_2 + leading_err;
+        if (analytic_) acc_runge_.add(analytic_(x0_ + step_h_2_ * node), runge);
+        else acc_runge_.add(runge);
+        acc_leading_.add(leading_err);
+        out_runge[count_out] = runge;
+        if (out_leading_error != nullptr) out_leading_error[count_out] = leading_err;
+        count_out++;
+        count_emitted_++;
+    }
+    T step_h_2_, inv_step_h_2_, inv_step_h_, x0_;
+    std::function<T(T)> analytic_;
+    Ring_buffer<T, ceil_pow2(ratio * (St::one_sided_size - 1) + 1)> buffer_; // Вмещает шаблон узла сетки h
+    Norm_accumulator<T> acc_runge_, acc_leading_;
+    std::size_t count_samples_ = 0;
+    std::size_t count_emitted_ = 0;
+    bool finished_ = false;
+};
+/**
+ * @brief Строка шаблона по нескольким строкам массива: dst[t] = sign * scale * sum_m(w[m] * rows[m][t]) (или dst[t] + ...), t = begin..end-1
+ * @tparam Size Количество строк шаблона
+ * @note Внутренний цикл идет по соседним ячейкам памяти и векторизуется
+ */
+template <std::size_t Size, typename T>
+inline void combine_rows(const T* const* rows, const T* weights, const T sign, const T scale, const bool accumulate,
+                         T* dst, const std::size_t begin, const std::size_t end){
+    for (std::size_t t = begin; t < end; t++){
+        T sum = 0;
+        for (std::size_t m = 0; m < Size; m++)
+            sum += weights[m] * rows[m][t];
+        dst[t] = accumulate ? dst[t] + sign * sum * scale : sign * sum * scale;
+    }
+}
+/**
+ * @brief Шаблон Stencil в узле i оси с шагом stride для участка [begin, end) непрерывной оси
+ * @param base Узел 0 оси
+ * @param count_axis Количество узлов вдоль оси
+ * @note Краевые узлы - односторонние формулы, остальные - центральный шаблон, порядок суммирования как в gen_derivative_func
+ */
+template <std::size_t Derivative_order, std::size_t Accuracy, typename T>
+void apply_stencil_node(const T* base, T* dst, const std::size_t i, const std::size_t count_axis, const std::size_t stride,
+                        const T scale, const bool accumulate, const std::size_t begin, const std::size_t end){
+    using St = Stencil<T, Derivative_order, Accuracy>;
+    constexpr std::size_t hw = St::half_width;
+    constexpr std::size_t os = St::one_sided_size;
+    constexpr std::size_t cs = St::central_size;
+    std::array<const T*, (cs > os ? cs : os)> rows{};
+    if (i < hw){ // Односторонняя формула у левого края
+        for (std::size_t m = 0; m < os; m++) rows[m] = base + m * stride;
+        combine_rows<os>(rows.data(), St::left[i].data(), T(1), scale, accumulate, dst, begin, end);
+    }
+    else if (i + hw >= count_axis){ // Зеркальная односторонняя формула у правого края
+        for (std::size_t m = 0; m < os; m++) rows[m] = base + (count_axis - 1 - m) * stride;
+        combine_rows<os>(rows.data(), St::left[count_axis - 1 - i].data(), St::right_sign, scale, accumulate, dst, begin, end);
+    }
+    else {
+        for (std::size_t m = 0; m < cs; m++) rows[m] = base + (i - hw + m) * stride;
+        combine_rows<cs>(rows.data(), St::central.data(), T(1), scale, accumulate, dst, begin, end);
+    }
+}
+/**
+ * @brief Шаблон Stencil вдоль непрерывной строки для узлов [begin, end): краевые узлы - односторонние формулы,
+ *        внутренние - ядром stencil_interior (копии под AVX2/AVX-512F), результат как в gen_derivative_func
+ * @param row Строка из count_axis узлов
+ * @param[out] dst Результат для узла t записывается в dst[t - begin] (Выходной параметр)
+ */
+template <std::size_t Derivative_order, std::size_t Accuracy, typename T>
+void apply_stencil_row(const T* row, T* dst, const std::size_t count_axis, const T scale, const std::size_t begin, const std::size_t end){
+    using St = Stencil<T, Derivative_order, Accuracy>;
+    constexpr std::size_t hw = St::half_width;
+    constexpr std::size_t os = St::one_sided_size;
+    auto boundary = [&](std::size_t t){
+        T sum = 0;
+        if (t < hw){
+            for (std::size_t k = 0; k < os; k++)
+                sum += St::left[t][k] * row[k];
+            return sum * scale;
+        }
+        for (std::size_t k = 0; k < os; k++)
+            sum += St::left[count_axis - 1 - t][k] * row[count_axis - 1 - k];
+        return St::right_sign * sum * scale;
+    };
+    const std::size_t lo = std::clamp(hw, begin, end), hi = std::clamp(count_axis - hw, begin, end);
+    for (std::size_t t = begin; t < lo; t++)
+        dst[t - begin] = boundary(t);
+    if (lo < hi) stencil_interior<St::central_size>(St::central.data(), row + lo - hw, dst + (lo - begin), hi - lo, scale);
+    for (std::size_t t = hi; t < end; t++)
+        dst[t - begin] = boundary(t);
+}
+/**
+ * @brief Применение шаблона Stencil вдоль одной оси массива, рассматриваемого как [count_outer][count_axis][count_inner]
+ * @tparam Derivative_order Порядок производной
+ * @tparam Accuracy Порядок точности шаблона
+ * @tparam T Тип данных (float, double, long double).
+ * @param in Входной массив
+ * @param[out] out Выходной массив того же размера (Выходной параметр)
+ * @param count_outer Произведение размеров осей до данной
+ * @param count_axis Количество узлов вдоль оси
+ * @param count_inner Произведение размеров осей после данной (шаг оси в памяти)
+ * @param scale Множитель 1 / step^Derivative_order
+ * @note Для оси с шагом count_inner > 1 обход идет тайлами шириной Parallel::tile_inner по непрерывной оси:
+ *       строки шаблона тайла остаются в кэше, внутренний цикл идет по соседним ячейкам памяти и векторизуется.
+ *       Непрерывная ось обрабатывается по строкам через apply_stencil_row. Тайлы распределяются по потокам.
+ */
+template <std::size_t Derivative_order, std::size_t Accuracy, typename T>
+void apply_stencil_along_axis(
+                const T* in,
+                T* out,
+                const std::size_t count_outer,
+                const std::size_t count_axis,
+                const std::size_t count_inner,
+                const T scale
+                ){
+    const std::size_t count_line = count_axis * count_inner;
+    if (count_inner == 1){ // Непрерывная ось: блоки из целых строк
+        const std::size_t rows_per_chunk = std::max<std::size_t>(1, Parallel::chunk_size / count_axis);
+        parallel_for_chunks(count_outer, [&](std::size_t, std::size_t begin, std::size_t end){
+            for (std::size_t o = begin; o < end; o++)
+                apply_stencil_row<Derivative_order, Accuracy>(in + o * count_line, out + o * count_line, count_axis, scale, 0, count_axis);
+        }, rows_per_chunk, count_axis);
+        return;
+    }
+    // Ось с шагом count_inner: элемент - линия (outer, t), блок - тайл из Parallel::tile_inner соседних линий
+    parallel_for_chunks(count_outer * count_inner, [&](std::size_t, std::size_t begin, std::size_t end){
+        for (std::size_t position = begin; position < end; ){
+            const std::size_t o = position / count_inner;
+            const std::size_t t_begin = position % count_inner;
+            const std::size_t t_end = std::min(count_inner, t_begin + (end - position));
+            for (std::size_t i = 0; i < count_axis; i++)
+                apply_stencil_node<Derivative_order, Accuracy>(in + o * count_line, out + o * count_line + i * count_inner,
+                                                                 i, count_axis, count_inner, scale, false, t_begin, t_end);
+            position += t_end - t_begin;
+        }
+    }, Parallel::tile_inner, count_axis);
+}
+/**
+ * @brief Функция для вычисления поля на N-мерной равномерной сетке
+ * @tparam T Тип данных (float, double, long double).
+ * @tparam Dim Размерность
+ * @param grid N-мерная сетка
+ * @param func Функция func(const std::array<T, Dim>& x) -> T
+ * @return Массив размера grid.size(), последняя ось непрерывна в памяти
+ */
+template <typename T, std::size_t Dim, typename Func>
+T* gen_field_nd(const Uniform_grid_nd<T, Dim>& grid, Func&& func){
+    const std::size_t count_last = grid.axis(Dim - 1).size();
+    T* field = new T[grid.size()]{};
+    parallel_for_chunks(grid.size() / count_last, [&](std::size_t, std::size_t begin, std::size_t end){
+        for (std::size_t row = begin; row < end; row++){
+            std::array<T, Dim> x{};
+            std::size_t rest = row;
+            for (std::size_t k = Dim - 1; k-- > 0;){ // Координаты строки по всем осям, кроме последней
+                x[k] = grid.axis(k)[rest % grid.axis(k).size()];
+                rest /= grid.axis(k).size();
+            }
+            for (std::size_t i = 0; i < count_last; i++){
+                x[Dim - 1] = grid.axis(Dim - 1)[i];
+                field[row * count_last + i] = func(x);
+            }
+        }
+    }, std::max<std::size_t>(1, Parallel::chunk_size / count_last), count_last);
+    return field;
+}
+/**
+ * @brief Функция для вычисления частной производной поля вдоль оси
+ * @tparam Derivative_order Порядок производной (По умолчанию 1)
+ * @tparam Accuracy Порядок точности шаблона (По умолчанию 2)
+ * @tparam T Тип данных (float, double, long double).
+ * @tparam Dim Размерность
+ * @param field Массив поля размера grid.size()
+ * @param grid N-мерная сетка
+ * @param axis Номер оси
+ * @return T* Указатель на массив частной производной размера grid.size()
+ */
+template <std::size_t Derivative_order, std::size_t Accuracy, typename T, std::size_t Dim>
+T* gen_partial_derivative(const T* field, const Uniform_grid_nd<T, Dim>& grid, const std::size_t axis){
+    if (field == nullptr) throw std::invalid_argument("field is null");
+    if (axis >= Dim) throw std::invalid_argument("Invalid axis");
+    if (grid.axis(axis).size() < Stencil<T, Derivative_order, Accuracy>::min_count_nodes) throw std::invalid_argument("Invalid count_nodes");
+
+    T scale = 1;
+    for (std::size_t k = 0; k < Derivative_order; k++)
+        scale /= grid.axis(axis).step();
+    T* derivative = new T[grid.size()]{};
+    try {
+        apply_stencil_along_axis<Derivative_order, Accuracy>(field, derivative, grid.count_outer(axis), grid.axis(axis).size(), grid.stride(axis), scale);
+    }
+    catch (...) { // Исключение из потока пула
+        delete[] derivative;
+        throw;
+    }
+    return derivative;
+}
+/**
+ * @brief Функция для вычисления градиента поля
+ * @tparam Accuracy Порядок точности шаблона (По умолчанию 2)
+ * @return Массив из Dim указателей на частные производные размера grid.size()
+ */
+template <std::size_t Accuracy, typename T, std::size_t Dim>
+std::array<T*, Dim> gen_gradient(const T* field, const Uniform_grid_nd<T, Dim>& grid){
+    if (field == nullptr) throw std::invalid_argument("field is null");
+    for (std::size_t k = 0; k < Dim; k++) // Все оси проверяются до выделения памяти
+        if (grid.axis(k).size() < Stencil<T, 1, Accuracy>::min_count_nodes) throw std::invalid_argument("Invalid count_nodes");
+    std::array<T*, Dim> gradient{};
+    try {
+        for (std::size_t k = 0; k < Dim; k++)
+            gradient[k] = gen_partial_derivative<1, Accuracy>(field, grid, k);
+    }
+    catch (...) { // Освобождение уже вычисленных компонент, например при std::bad_alloc
+        for (T* component : gradient)
+            delete[] component;
+        throw;
+    }
+    return gradient;
+}
+/**
+ * @brief Функция для вычисления лапласиана поля
+ * @tparam Accuracy Порядок точности шаблона (По умолчанию 2)
+ * @return T* Указатель на массив размера grid.size()
+ * @note Один проход по выходному массиву участками из Parallel::tile_inner узлов непрерывной оси: в участок по очереди
+ *       прибавляются вторые производные по всем осям, пока он в кэше. Соседние строки по другим осям читаются из кэша
+ *       при обработке соседних участков, поэтому обмен с памятью на узел близок к одномерному случаю.
+ *       Результат совпадает с суммой gen_partial_derivative<2> по осям 0..Dim-1.
+ */
+template <std::size_t Accuracy, typename T, std::size_t Dim>
+T* gen_laplacian(const T* field, const Uniform_grid_nd<T, Dim>& grid){
+    if (field == nullptr) throw std::invalid_argument("field is null");
+    for (std::size_t k = 0; k < Dim; k++) // Все оси проверяются до выделения памяти
+        if (grid.axis(k).size() < Stencil<T, 2, Accuracy>::min_count_nodes) throw std::invalid_argument("Invalid count_nodes");
+
+    std::array<T, Dim> scale{};
+    for (std::size_t k = 0; k < Dim; k++)
+        scale[k] = 1 / (grid.axis(k).step() * grid.axis(k).step());
+    const std::size_t count_last = grid.axis(Dim - 1).size();
+    // Участок [t_begin, t_end) строки line непрерывной оси
+    auto apply_segment = [&](T* laplacian, std::size_t line, std::size_t t_begin, std::size_t t_end){
+        T* dst = laplacian + line * count_last;
+        for (std::size_t k = 0; k + 1 < Dim; k++){
+            const std::size_t stride = grid.stride(k), count_axis = grid.axis(k).size();
+            const std::size_t i = line / (stride / count_last) % count_axis; // Индекс строки вдоль оси k
+            apply_stencil_node<2, Accuracy>(field + line * count_last - i * stride, dst, i, count_axis, stride, scale[k], k > 0, t_begin, t_end);
+        }
+        T values[Parallel::tile_inner];
+        apply_stencil_row<2, Accuracy>(field + line * count_last, values, count_last, scale[Dim - 1], t_begin, t_end);
+        for (std::size_t t = t_begin; t < t_end; t++)
+            dst[t] = Dim == 1 ? values[t - t_begin] : dst[t] + values[t - t_begin];
+    };
+
+    T* laplacian = new T[grid.size()]{};
+    try {
+        parallel_for_chunks(grid.size(), [&](std::size_t, std::size_t begin, std::size_t end){
+            for (std::size_t position = begin; position < end; ){
+                const std::size_t line = position / count_last;
+                const std::size_t t_begin = position % count_last;
+                const std::size_t t_end = std::min(count_last, t_begin + (end - position));
+                apply_segment(laplacian, line, t_begin, t_end);
+                position += t_end - t_begin;
+            }
+        }, Parallel::tile_inner, Dim);
+    }
+    catch (...) { // Исключение из потока пула
+        delete[] laplacian;
+        throw;
+    }
+    return laplacian;
+}
+/**
+ * @brief Функция для уточнения производной по Рунге-Ромбергу на N-мерной сетке
+ * @tparam T Тип данных (float, double, long double).
+ * @tparam Dim Размерность
+ * @param derivative_more_freq Массив производной на сетке grid_more_freq = grid_less_freq.refined(2)
+ * @param derivative_less_freq Массив производной на сетке grid_less_freq
+ * @param grid_more_freq Более частая сетка
+ * @param grid_less_freq Менее частая сетка
+ * @param accuracy Порядок точности исходной формулы (По умолчанию 2)
+ * @return Пара массивов pair(runge_romberg, leading_error) размера grid_less_freq.size()
+ */
+template <typename T, std::size_t Dim>
+std::pair<T*, T*> gen_runge_romberg_nd(
+                const T* derivative_more_freq,
+                const T* derivative_less_freq,
+                const Uniform_grid_nd<T, Dim>& grid_more_freq,
+                const Uniform_grid_nd<T, Dim>& grid_less_freq,
+                const std::size_t accuracy
+                ){
+    if (derivative_more_freq == nullptr || derivative_less_freq == nullptr)
+        throw std::invalid_argument("grids is null");
+    const std::size_t ratio = 2;
+    for (std::size_t k = 0; k < Dim; k++)
+        if (grid_more_freq.axis(k).size() != grid_less_freq.axis(k).size() * ratio - (ratio - 1))
+            throw std::invalid_argument("Invalid count_nodes");
+    if (accuracy < 1) throw std::invalid_argument("Invalid accuracy");
+
+    const T denominator = std::pow(T(ratio), static_cast<T>(accuracy)) - 1;
+    const std::size_t count_last = grid_less_freq.axis(Dim - 1).size();
+    T* runge_romberg = new T[grid_less_freq.size()]{};
+    T* leading_error = nullptr;
+    try {
+        leading_error = new T[grid_less_freq.size()]{};
+        parallel_for_chunks(grid_less_freq.size() / count_last, [&](std::size_t, std::size_t begin, std::size_t end){
+            for (std::size_t row = begin; row < end; row++){
+                std::size_t offset_more = 0, rest = row; // Начало той же строки на частой сетке
+                for (std::size_t k = Dim - 1; k-- > 0;){
+                    offset_more += (rest % grid_less_freq.axis(k).size()) * ratio * grid_more_freq.stride(k);
+                    rest /= grid_less_freq.axis(k).size();
+                }
+                for (std::size_t i = 0; i < count_last; i++){
+                    std::size_t j = row * count_last + i;
+                    T leading_err = (derivative_more_freq[offset_more + i * ratio] - derivative_less_freq[j]) / denominator;
+                    runge_romberg[j] = derivative_more_freq[offset_more + i * ratio] + leading_err;
+                    leading_error[j] = leading_err;
+                }
+            }
+        }, std::max<std::size_t>(1, Parallel::chunk_size / count_last), count_last);
+    }
+    catch (...) { // Исключение из потока пула
+        delete[] runge_romberg;
+        delete[] leading_error;
+        throw;
+    }
+    return std::make_pair(runge_romberg, leading_error);
 }
 /**
  * @brief Функция вывода значений абсолютной и относительной погрешностей в формате таблицы
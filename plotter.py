@@ -1,21 +1,82 @@
+import sys
 import json
+import struct
+import numpy as np
 import seaborn as sns
 import matplotlib.pyplot as plt
 
+# Максимальное количество точек графика аналитической производной, больше - прореживание с сохранением min/max
+MAX_VIZ_POINTS = 20000
 
-def plot_graph_seaborn(filename):
+
+class Grid:
+    """Неявная равномерная сетка из двоичного файла (узлы не хранятся)"""
+    def __init__(self, a, b, count):
+        self.a, self.b, self.count = a, b, count
+
+    def __len__(self):
+        return self.count
+
+    def __getitem__(self, idx):
+        idx = np.asarray(idx)
+        step = (self.b - self.a) / (self.count - 1)
+        return np.where(idx == self.count - 1, self.b, self.a + idx * step)
+
+
+def load_binary(filename):
+    # Формат data.bin описан в numerical_differentiation.tpp (Binary_format)
+    with open(filename, 'rb') as file:
+        magic, version, count = struct.unpack('<8sII', file.read(16))
+        if magic != b'NDIFFBIN' or version != 1:
+            raise ValueError("Unsupported file format")
+        entries = [struct.unpack('<40s8sQQ', file.read(64)) for _ in range(count)]
+
+    data = {}
+    for name, dtype, offset, length in entries:
+        name = name.rstrip(b'\0').decode()
+        dtype = dtype.rstrip(b'\0').decode()
+        if dtype == 'grid':
+            a, b = np.memmap(filename, dtype='<f8', mode='r', offset=offset, shape=(2,))
+            data[name] = Grid(float(a), float(b), length)
+        else:
+            data[name] = np.memmap(filename, dtype=dtype, mode='r', offset=offset, shape=(length,))
+    return data
+
+
+def load_json(filename):
     # Чтение JSON данных из файла
     with open(filename, 'r') as file:
         data = json.load(file)
+    return {name: np.asarray(values) for name, values in data.items()}
 
-    # Преобразование двумерных массивов в одномерные
-    grid_M_viz = data['grid_M_viz']
-    grid_h = data['grid_h']
-    grid_h_2 = data['grid_h_2']
-    derivative_analytics = data['derivative_analytics']
-    derivative_in_h = data['derivative_in_h']
-    derivative_in_h_2 = data['derivative_in_h_2']
-    updated_runge = data['updated_runge']
+
+def decimate_min_max(values, max_points):
+    """Индексы точек после прореживания: в каждом блоке остаются минимум и максимум"""
+    count = len(values)
+    if max_points <= 0 or count <= max_points:
+        return np.arange(count)
+    buckets = max(max_points // 2, 1)
+    size = count // buckets
+    full = buckets * size
+    blocks = np.asarray(values[:full]).reshape(buckets, size)
+    starts = np.arange(buckets) * size
+    idx = np.concatenate([starts + blocks.argmin(axis=1), starts + blocks.argmax(axis=1), np.arange(full, count)])
+    return np.unique(idx)
+
+
+def plot_graph_seaborn(filename):
+    data = load_binary(filename) if filename.endswith('.bin') else load_json(filename)
+
+    grid_h = data['grid_h'][np.arange(len(data['grid_h']))]
+    grid_h_2 = data['grid_h_2'][np.arange(len(data['grid_h_2']))]
+    derivative_in_h = np.asarray(data['derivative_in_h'])
+    derivative_in_h_2 = np.asarray(data['derivative_in_h_2'])
+    updated_runge = np.asarray(data['updated_runge'])
+
+    # Прореживание мелкой сетки, чтобы график строился быстро при любом размере
+    viz_idx = decimate_min_max(data['derivative_analytics'], MAX_VIZ_POINTS)
+    grid_M_viz = data['grid_M_viz'][viz_idx]
+    derivative_analytics = np.asarray(data['derivative_analytics'][viz_idx])
 
     # Установка темы и стиля
     sns.set_theme(style="whitegrid", palette="muted", font="serif", font_scale=1.2)
@@ -45,6 +106,4 @@ def plot_graph_seaborn(filename):
     plt.show()
 
 # Вызов функции
-plot_graph_seaborn("data.json")
-
-
+plot_graph_seaborn(sys.argv[1] if len(sys.argv) > 1 else "data.bin")
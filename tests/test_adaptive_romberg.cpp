@@ -0,0 +1,75 @@
+#include <iostream>
+#include <algorithm>
+#include "numerical_differentiation.hpp"
+#include "test_utils.hpp"
+
+/// Максимум |derivative - cos| и максимум по узлам количества уровней
+template <typename T>
+std::pair<T, std::size_t> max_error(const Romberg_result<T>& result, const Uniform_grid<T>& grid){
+    T error = 0;
+    std::size_t levels = 0;
+    for (std::size_t j = 0; j < grid.size(); j++){
+        error = std::max(error, std::abs(result.derivative[j] - std::cos(grid[j])));
+        levels = std::max(levels, result.levels[j]);
+    }
+    return {error, levels};
+}
+template <typename T>
+void free_result(Romberg_result<T>& result){
+    delete[] result.derivative;
+    delete[] result.leading_error;
+    delete[] result.levels;
+}
+
+int main(){
+    const Uniform_grid<double> grid(-4.0, 4.0, 30);
+    auto func = [](double x) { return std::sin(x); };
+    const double tolerance = 1e-10;
+
+    // Одно разбиение на всю сетку: при верных знаменателях (2^(2m)-1 внутри, 2^(m+1)-1 на краях) точность доходит до tolerance
+    auto global = gen_adaptive_romberg(grid, func, tolerance);
+    auto [error_global, levels_global] = max_error(global, grid);
+    Test::check(error_global < 1e-9, "global: error " + Test::format(error_global));
+    Test::check(levels_global >= 2 && levels_global < 10, "global: levels " + std::to_string(levels_global));
+    Test::check_near(global.derivative[0], std::cos(grid[0]), 1e-9, "global: left edge");
+    Test::check_near(global.derivative[grid.size() - 1], std::cos(grid[grid.size() - 1]), 1e-9, "global: right edge");
+    for (std::size_t j = 0; j < grid.size(); j++)
+        Test::check(std::abs(global.leading_error[j]) < tolerance, "global: leading_error at " + std::to_string(j));
+
+    // Подынтервалы по 7 узлов останавливаются независимо, функция вычисляется не чаще, чем в глобальном режиме
+    auto local = gen_adaptive_romberg(grid, func, tolerance, 10, 7);
+    auto [error_local, levels_local] = max_error(local, grid);
+    Test::check(error_local < 1e-9, "interval_nodes: error " + Test::format(error_local));
+    Test::check(levels_local <= levels_global, "interval_nodes: levels");
+    Test::check(local.count_evaluations <= global.count_evaluations, "interval_nodes: count_evaluations");
+
+    // Три уровня без остановки: внутри исключаются h^2, h^4, h^6 (знаменатели 2^(2m)-1), на краях - h^2, h^3, h^4 (2^(m+1)-1).
+    // При неверных знаменателях ошибка больше на 2-3 порядка
+    auto three_levels = gen_adaptive_romberg(grid, func, 1e-30, 3);
+    double error_interior = 0, error_edge = 0;
+    for (std::size_t j = 0; j < grid.size(); j++){
+        const double error = std::abs(three_levels.derivative[j] - std::cos(grid[j]));
+        if (j == 0 || j == grid.size() - 1) error_edge = std::max(error_edge, error);
+        else error_interior = std::max(error_interior, error);
+        Test::check(three_levels.levels[j] == 3, "max_levels = 3: levels at " + std::to_string(j));
+    }
+    Test::check(error_interior < 1e-12, "max_levels = 3: interior error " + Test::format(error_interior));
+    Test::check(error_edge < 1e-6, "max_levels = 3: edge error " + Test::format(error_edge));
+
+    // Результат не зависит от количества потоков
+    Parallel::thread_count = 4;
+    Parallel::min_parallel_nodes = 1;
+    auto parallel = gen_adaptive_romberg(grid, func, tolerance, 10, 7);
+    Test::check(std::equal(parallel.derivative, parallel.derivative + grid.size(), local.derivative), "threads: derivative");
+    Test::check(parallel.count_evaluations == local.count_evaluations, "threads: count_evaluations");
+
+    bool thrown = false;
+    try { gen_adaptive_romberg(grid, func, -1.0); } catch (const std::invalid_argument&) { thrown = true; }
+    Test::check(thrown, "negative tolerance throws");
+
+    free_result(global);
+    free_result(local);
+    free_result(three_levels);
+    free_result(parallel);
+    return Test::result("test_adaptive_romberg");
+}
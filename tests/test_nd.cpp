@@ -0,0 +1,106 @@
+#include <iostream>
+#include <array>
+#include <cmath>
+#include <algorithm>
+#include "numerical_differentiation.hpp"
+#include "test_utils.hpp"
+
+/// Максимум модуля разности массива и поля, посчитанного аналитически
+template <typename T, std::size_t Dim, typename Func>
+T max_error(const T* values, const Uniform_grid_nd<T, Dim>& grid, Func&& analytic){
+    T* expected = gen_field_nd(grid, analytic);
+    T error = 0;
+    for (std::size_t j = 0; j < grid.size(); j++)
+        error = std::max(error, std::abs(values[j] - expected[j]));
+    delete[] expected;
+    return error;
+}
+
+/// Квадратичный многочлен: шаблоны второго порядка точны, ошибка - только округление
+void check_polynomial_2d(){
+    const Uniform_grid_nd<double, 2> grid({Uniform_grid<double>(-1.0, 1.0, 21), Uniform_grid<double>(0.0, 2.0, 33)});
+    auto f = [](const std::array<double, 2>& x){ return 3 * x[0] * x[0] - 2 * x[0] * x[1] + x[1] * x[1] + x[0]; };
+    double* field = gen_field_nd(grid, f);
+
+    auto gradient = gen_gradient(field, grid);
+    Test::check_near(max_error(gradient[0], grid, [](const std::array<double, 2>& x){ return 6 * x[0] - 2 * x[1] + 1; }), 0.0, 1e-11, "2D gradient x");
+    Test::check_near(max_error(gradient[1], grid, [](const std::array<double, 2>& x){ return -2 * x[0] + 2 * x[1]; }), 0.0, 1e-11, "2D gradient y");
+    double* laplacian = gen_laplacian(field, grid);
+    Test::check_near(max_error(laplacian, grid, [](const std::array<double, 2>&){ return 8.0; }), 0.0, 1e-9, "2D laplacian");
+
+    delete[] field; delete[] laplacian;
+    for (auto* component : gradient) delete[] component;
+}
+
+/// Лапласиан за один проход совпадает с суммой вторых производных по осям поэлементно
+template <std::size_t Accuracy>
+void check_laplacian_sum_3d(){
+    const std::string name = "3D laplacian<" + std::to_string(Accuracy) + ">";
+    const Uniform_grid_nd<double, 3> grid({Uniform_grid<double>(0.0, 1.0, 13), Uniform_grid<double>(-1.0, 1.0, 17),
+                                           Uniform_grid<double>(0.0, 2.0, 515)});
+    auto f = [](const std::array<double, 3>& x){ return std::sin(x[0]) * std::cos(x[1]) * std::exp(x[2] / 2); };
+    double* field = gen_field_nd(grid, f);
+
+    double* laplacian = gen_laplacian<Accuracy>(field, grid);
+    double* expected = new double[grid.size()]{};
+    for (std::size_t k = 0; k < 3; k++){
+        double* partial = gen_partial_derivative<2, Accuracy>(field, grid, k);
+        for (std::size_t j = 0; j < grid.size(); j++)
+            expected[j] = k == 0 ? partial[j] : expected[j] + partial[j];
+        delete[] partial;
+    }
+    Test::check(std::equal(expected, expected + grid.size(), laplacian), name + ": sum of partials");
+    // Δf = (-1 - 1 + 1/4) f, при измельчении сетки вдвое ошибка падает примерно в 2^Accuracy раз
+    auto analytic = [&](const std::array<double, 3>& x){ return -1.75 * f(x); };
+    const auto grid_h_2 = grid.refined(2);
+    double* field_h_2 = gen_field_nd(grid_h_2, f);
+    double* laplacian_h_2 = gen_laplacian<Accuracy>(field_h_2, grid_h_2);
+    const double error_h = max_error(laplacian, grid, analytic);
+    const double error_h_2 = max_error(laplacian_h_2, grid_h_2, analytic);
+    Test::check(error_h_2 < error_h / (0.75 * (1 << Accuracy)), name + ": order " + Test::format(error_h_2) + " vs " + Test::format(error_h));
+
+    delete[] field; delete[] laplacian; delete[] expected;
+    delete[] field_h_2; delete[] laplacian_h_2;
+}
+
+/// Первая производная по оси с шагом: уточнение Рунге-Ромберга на сетке, измельченной вдвое, уменьшает ошибку
+void check_runge_romberg_3d(){
+    const Uniform_grid_nd<double, 3> grid_h({Uniform_grid<double>(0.0, 1.0, 9), Uniform_grid<double>(-1.0, 1.0, 11),
+                                             Uniform_grid<double>(0.0, 2.0, 15)});
+    const auto grid_h_2 = grid_h.refined(2);
+    auto f = [](const std::array<double, 3>& x){ return std::sin(x[0]) * std::cos(x[1]) * std::exp(x[2] / 2); };
+    auto df = [](const std::array<double, 3>& x){ return -std::sin(x[0]) * std::sin(x[1]) * std::exp(x[2] / 2); };
+    double* field_h = gen_field_nd(grid_h, f);
+    double* field_h_2 = gen_field_nd(grid_h_2, f);
+
+    double* derivative_h = gen_partial_derivative(field_h, grid_h, 1);
+    double* derivative_h_2 = gen_partial_derivative(field_h_2, grid_h_2, 1);
+    auto runge = gen_runge_romberg_nd(derivative_h_2, derivative_h, grid_h_2, grid_h);
+    const double error_h = max_error(derivative_h, grid_h, df);
+    const double error_runge = max_error(runge.first, grid_h, df);
+    Test::check(error_runge < error_h / 10, "3D Runge-Romberg: " + Test::format(error_runge) + " vs " + Test::format(error_h));
+    Test::check_throws([&]{ gen_runge_romberg_nd(derivative_h, derivative_h, grid_h, grid_h); }, "3D Runge-Romberg: grid mismatch");
+
+    delete[] field_h; delete[] field_h_2; delete[] derivative_h; delete[] derivative_h_2;
+    delete[] runge.first; delete[] runge.second;
+}
+
+/// Ошибки аргументов
+void check_invalid(){
+    const Uniform_grid_nd<double, 2> grid({Uniform_grid<double>(0.0, 1.0, 2), Uniform_grid<double>(0.0, 1.0, 8)});
+    double* field = gen_field_nd(grid, [](const std::array<double, 2>& x){ return x[0] + x[1]; });
+    Test::check_throws([&]{ gen_partial_derivative(field, grid, 2); }, "invalid axis");
+    Test::check_throws([&]{ gen_gradient(field, grid); }, "gradient: short axis");
+    Test::check_throws([&]{ gen_laplacian(field, grid); }, "laplacian: short axis");
+    Test::check_throws([&]{ gen_laplacian(static_cast<const double*>(nullptr), grid); }, "laplacian: null field");
+    delete[] field;
+}
+
+int main(){
+    check_polynomial_2d();
+    check_laplacian_sum_3d<2>();
+    check_laplacian_sum_3d<4>();
+    check_runge_romberg_3d();
+    check_invalid();
+    return Test::result("nd derivatives");
+}
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include "numerical_differentiation.hpp"
+#include "test_utils.hpp"
+
+/// Размеры блоков 1, 3, 2, 7, 5, ... - поток подается неравномерными порциями
+std::size_t next_block(const std::size_t block){ return block * 3 % 7 + 1; }
+
+/// Stream_differentiator совпадает с gen_derivative_func поэлементно, нормы - с calculate_norms
+template <std::size_t Accuracy>
+void check_stream(const std::size_t count_nodes){
+    const std::string name = "Stream_differentiator<" + std::to_string(Accuracy) + "> n=" + std::to_string(count_nodes);
+    const Uniform_grid<double> grid(-1.0, 2.0, count_nodes);
+    std::vector<double> func(count_nodes), analytic(count_nodes);
+    for (std::size_t i = 0; i < count_nodes; i++){
+        func[i] = std::sin(grid[i]);
+        analytic[i] = std::cos(grid[i]);
+    }
+    const double* expected = gen_derivative_func<1, Accuracy>(func.data(), count_nodes, grid.step());
+    auto expected_norms = calculate_norms(analytic.data(), expected, count_nodes);
+
+    Stream_differentiator<double, Accuracy> stream(grid.step(), grid.a(), [](double x) { return std::cos(x); });
+    std::vector<double> out(count_nodes + Stencil<double, 1, Accuracy>::half_width);
+    std::size_t count_out = 0;
+    for (std::size_t pos = 0, block = 1; pos < count_nodes; pos += block, block = next_block(block)){
+        block = std::min(block, count_nodes - pos);
+        count_out += stream.push(func.data() + pos, block, out.data() + count_out);
+    }
+    count_out += stream.finish(out.data() + count_out);
+
+    Test::check(count_out == count_nodes && stream.count_emitted() == count_nodes, name + ": count");
+    Test::check(std::equal(expected, expected + count_nodes, out.data()), name + ": derivative");
+    auto norms = stream.norms();
+    Test::check(std::equal(norms.first, norms.first + Norms::Count, expected_norms.first), name + ": norms abs");
+    Test::check(std::equal(norms.second, norms.second + Norms::Count, expected_norms.second), name + ": norms rel");
+
+    delete[] expected;
+    delete[] expected_norms.first; delete[] expected_norms.second;
+    delete[] norms.first; delete[] norms.second;
+}
+/// Stream_runge_differentiator совпадает с gen_fused_pipeline (уточнение, главный член погрешности и их нормы)
+template <std::size_t Accuracy>
+void check_runge_stream(const std::size_t count_nodes_h_2){
+    const std::string name = "Stream_runge_differentiator<" + std::to_string(Accuracy) + "> n=" + std::to_string(count_nodes_h_2);
+    const Uniform_grid<double> grid(-1.0, 2.0, count_nodes_h_2);
+    std::vector<double> func(count_nodes_h_2), analytic(count_nodes_h_2);
+    for (std::size_t i = 0; i < count_nodes_h_2; i++){
+        func[i] = std::sin(grid[i]);
+        analytic[i] = std::cos(grid[i]);
+    }
+    auto expected = gen_fused_pipeline<Accuracy>(func.data(), analytic.data(), count_nodes_h_2, grid.step());
+    const std::size_t count_nodes_h = expected.count_nodes_h;
+
+    Stream_runge_differentiator<double, Accuracy> stream(grid.step(), grid.a(), [](double x) { return std::cos(x); });
+    std::vector<double> runge(count_nodes_h + Stencil<double, 1, Accuracy>::half_width + 1), leading_error(runge.size());
+    std::size_t count_out = 0;
+    for (std::size_t pos = 0, block = 2; pos < count_nodes_h_2; pos += block, block = next_block(block)){
+        block = std::min(block, count_nodes_h_2 - pos);
+        count_out += stream.push(func.data() + pos, block, runge.data() + count_out, leading_error.data() + count_out);
+    }
+    count_out += stream.finish(runge.data() + count_out, leading_error.data() + count_out);
+
+    Test::check(count_out == count_nodes_h, name + ": count");
+    Test::check(std::equal(expected.updated_runge, expected.updated_runge + count_nodes_h, runge.data()), name + ": runge");
+    Test::check(std::equal(expected.leading_error, expected.leading_error + count_nodes_h, leading_error.data()), name + ": leading_error");
+    auto norms = stream.norms_runge();
+    Test::check(std::equal(norms.first, norms.first + Norms::Count, expected.errors_runge.first), name + ": norms abs");
+    Test::check(std::equal(norms.second, norms.second + Norms::Count, expected.errors_runge.second), name + ": norms rel");
+    double* norms_leading = stream.norms_leading_error();
+    Test::check(std::equal(norms_leading, norms_leading + Norms::Count, expected.norms_leading_error), name + ": norms leading_error");
+
+    for (double* array : {expected.derivative_in_h, expected.derivative_in_h_2, expected.updated_runge, expected.leading_error,
+                          expected.errors_in_h.first, expected.errors_in_h.second, expected.errors_in_h_2.first, expected.errors_in_h_2.second,
+                          expected.errors_runge.first, expected.errors_runge.second, expected.norms_leading_error,
+                          norms.first, norms.second, norms_leading})
+        delete[] array;
+}
+
+int main(){
+    for (std::size_t count_nodes : {3, 4, 5, 17, 100, 1001}){
+        check_stream<2>(count_nodes);
+        if (count_nodes >= 5) check_stream<4>(count_nodes);
+    }
+    for (std::size_t count_nodes_h_2 : {5, 9, 11, 101, 2001}){
+        check_runge_stream<2>(count_nodes_h_2);
+        if (count_nodes_h_2 >= 9) check_runge_stream<4>(count_nodes_h_2);
+    }
+
+    // Поток после finish() не принимает отсчеты, слишком короткий поток не завершается
+    Stream_differentiator<double> stream(0.1);
+    double out[4];
+    stream.push(1.0, out);
+    stream.push(2.0, out);
+    bool thrown = false;
+    try { stream.finish(out); } catch (const std::invalid_argument&) { thrown = true; }
+    Test::check(thrown, "finish with 2 samples throws");
+    stream.push(3.0, out);
+    Test::check(stream.finish(out) == 1 && stream.finish(out) == 0, "finish once");
+    thrown = false;
+    try { stream.push(4.0, out); } catch (const std::logic_error&) { thrown = true; }
+    Test::check(thrown, "push after finish throws");
+
+    return Test::result("test_streaming");
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace Test {
+    inline int count_failed = 0; ///Количество непрошедших проверок
+
+    /// Проверка условия, при ошибке печатает сообщение
+    inline void check(const bool condition, const std::string& message){
+        if (condition) return;
+        count_failed++;
+        std::cerr << "FAILED: " << message << "\n";
+    }
+    /// Число в экспоненциальной записи для сообщений
+    template <typename T>
+    std::string format(const T value){
+        std::ostringstream out;
+        out << std::scientific << std::setprecision(6) << static_cast<long double>(value);
+        return out.str();
+    }
+    /// Проверка |actual - expected| <= tolerance
+    template <typename T>
+    void check_near(const T actual, const T expected, const T tolerance, const std::string& message){
+        check(std::abs(actual - expected) <= tolerance, message + ": " + format(actual) + " != " + format(expected));
+    }
+    /// Проверка, что вызов бросает std::invalid_argument
+    template <typename Func>
+    void check_throws(Func&& func, const std::string& message){
+        try { func(); }
+        catch (const std::invalid_argument&) { return; }
+        check(false, message + ": no std::invalid_argument");
+    }
+    /// Код возврата теста: 0, если все проверки прошли
+    inline int result(const std::string& name){
+        std::cout << name << ": " << (count_failed == 0 ? "OK" : std::to_string(count_failed) + " failed") << "\n";
+        return count_failed == 0 ? 0 : 1;
+    }
+}